@@ -0,0 +1,31 @@
+/********************************************************************************
+  * @file    	dwt.c
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Cycle counter of the Cortex-M4 data watchpoint and trace unit.
+********************************************************************************/
+
+/* Includes -------------------------------------------------------------------*/
+#include "dwt.h"
+
+/* External variables ---------------------------------------------------------*/
+/* Private typedefs -----------------------------------------------------------*/
+/* Private defines ------------------------------------------------------------*/
+/* Private macros -------------------------------------------------------------*/
+/* Private variables ----------------------------------------------------------*/
+/* Private function prototypes ------------------------------------------------*/
+/* Functions ------------------------------------------------------------------*/
+
+/**
+ * @fn DWT_CycleCounterInit
+ * @brief Enable the DWT cycle counter. Safe to call more than once, the
+ * counter is not reset.
+ */
+void DWT_CycleCounterInit() {
+	/* Enable trace unit */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	/* Start cycle counter */
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
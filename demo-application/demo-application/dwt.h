@@ -0,0 +1,32 @@
+/********************************************************************************
+  * @file    	dwt.h
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Cycle counter of the Cortex-M4 data watchpoint and trace unit.
+********************************************************************************/
+
+#ifndef _dwt_h
+#define _dwt_h
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l4xx.h"
+
+/* Public typedefs -----------------------------------------------------------*/
+/* Public defines ------------------------------------------------------------*/
+/* Public macros -------------------------------------------------------------*/
+/* Public variables ----------------------------------------------------------*/
+/* Public function prototypes ------------------------------------------------*/
+void DWT_CycleCounterInit();
+
+/**
+ * @fn DWT_GetCycles
+ * @brief Read the free running cycle counter (80 cycles = 1 us at 80 MHz).
+ * @return Current cycle count. Use unsigned subtraction for differences.
+ */
+static inline uint32_t DWT_GetCycles() {
+	return DWT->CYCCNT;
+}
+
+#endif /* _dwt_h */
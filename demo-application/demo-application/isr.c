@@ -14,6 +14,9 @@
 
 /* External variables --------------------------------------------------------*/
 extern DMA_HandleTypeDef hdma_tim2_ch2_ch7;
+extern DMA_HandleTypeDef hdma_spi2_tx;
+extern DMA_HandleTypeDef hdma_spi2_rx;
+extern SPI_HandleTypeDef hspi;
 extern TIM_HandleTypeDef TIM_HandleBTN;
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -30,6 +33,30 @@ void DMA1_Channel7_IRQHandler(void) {
   HAL_DMA_IRQHandler(&hdma_tim2_ch2_ch7);
 }
 
+/**
+ * @fn DMA1_Channel4_IRQHandler
+ * @brief Handles DMA1 channel4 (SPI2_RX) global interrupt.
+ */
+void DMA1_Channel4_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&hdma_spi2_rx);
+}
+
+/**
+ * @fn DMA1_Channel5_IRQHandler
+ * @brief Handles DMA1 channel5 (SPI2_TX) global interrupt.
+ */
+void DMA1_Channel5_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&hdma_spi2_tx);
+}
+
+/**
+ * @fn SPI2_IRQHandler
+ * @brief Handles SPI2 global interrupt.
+ */
+void SPI2_IRQHandler(void) {
+  HAL_SPI_IRQHandler(&hspi);
+}
+
 /**
  * @fn TIM4_IRQHandler
  * @brief Handles TIM3 interrupt requests.
@@ -9,15 +9,574 @@
 ********************************************************************************/
 
 /* Includes -------------------------------------------------------------------*/
+#include <string.h>
 #include "lcd.h"
 #include "spi.h"
+#include "dwt.h"
+#include "lcd_drawing.h"
 
 /* External variables ---------------------------------------------------------*/
 /* Private typedefs -----------------------------------------------------------*/
 /* Private defines ------------------------------------------------------------*/
+/* Controller cursor unknown, the next write sends page and column */
+#define LCD_CURSOR_INVALID		0xFF
+/* Profiler overlay: LCD_PROFILER_ROWS lines of LCD_PROFILER_COLUMNS characters
+ * of LCD_Font_6x7int in the top right corner */
+#define LCD_PROFILER_COLUMNS	7
+#define LCD_PROFILER_ROWS		3
+#define LCD_PROFILER_X			(LCD_Width - 6 * LCD_PROFILER_COLUMNS)
 /* Private macros -------------------------------------------------------------*/
+/* Display RAM page shown at a logical page, see LCD_ScrollUp */
+#define LCD_RAM_PAGE(page)	(((page) + LCD_PageOffset) & (LCD_Pages - 1))
 /* Private variables ----------------------------------------------------------*/
+/* Init sequence for internal voltage generation */
+static const uint8_t LCD_DefaultInitCommands[] = {
+	0x40,					/* Display start line 0 */
+	0xA1,					/* ADC reverse */
+	0xC0,					/* Common output mode: normal COM0~COM63 */
+	0xA6,					/* Display normal */
+	LCD_INIT_BIAS,			/* LCD bias set (Duty 1/65) */
+	0x2F,					/* Power control: booster, regulator and follower on */
+	0xF8, 0x00,				/* Booster ratio: internal booster 4x */
+	LCD_INIT_REGULATOR,		/* V0 voltage regulator set */
+	0x81, LCD_INIT_CONTRAST,	/* Electronic volume mode set: contrast */
+	0xAC, 0x00,				/* Static indicator: no indicator */
+	0xAF					/* Display ON */
+};
+
+/* Copies of the display RAM, organised like the controller: [page][column].
+ * Drawing goes to the back buffer LCD_FrameBuffer, the other one is the front
+ * buffer that LCD_SwapBuffers hands to the background flush. */
+static uint8_t LCD_Buffers[2][LCD_Pages][LCD_Width];
+static uint8_t (*LCD_FrameBuffer)[LCD_Width] = LCD_Buffers[0];
+static uint8_t (*LCD_FrontBuffer)[LCD_Width] = LCD_Buffers[1];
+/* Dirty column range per page, first > last means the page is clean */
+static uint8_t LCD_DirtyFirst[LCD_Pages];
+static uint8_t LCD_DirtyLast[LCD_Pages];
+static LCD_DRAW_MODE LCD_DrawMode = LCD_DRAW_DIRECT;
+/* Hardware scrolling: logical page 0 is shown from RAM page LCD_PageOffset.
+ * In buffered mode the start line command waits for the next flush. */
+static uint8_t LCD_PageOffset = 0;
+static uint8_t LCD_StartLinePending = 0;
+/* Page and column the controller writes the next data byte to. Follows the
+ * column auto-increment, so consecutive writes skip the address commands. */
+static uint8_t LCD_CursorPage = LCD_CURSOR_INVALID;
+static uint8_t LCD_CursorColumn = LCD_CURSOR_INVALID;
+/* Nesting of LCD_AcquireBus, the bus is released by the outermost call and
+ * only if that call acquired it */
+static uint8_t LCD_BusDepth = 0;
+static uint8_t LCD_BusAcquired = 0;
+
+/* Background flush of the front buffer, driven by the SPI2 queue */
+static uint8_t LCD_FlushFirst[LCD_Pages];
+static uint8_t LCD_FlushLast[LCD_Pages];
+static uint8_t LCD_FlushCmd[3];
+static volatile uint8_t LCD_FlushPage = LCD_Pages;
+static volatile uint8_t LCD_FlushBusy = 0;
+static volatile uint8_t LCD_FlushStalled = 0;
+/* An address phase failed, the data phase of the page must not complete it */
+static volatile uint8_t LCD_FlushFailed = 0;
+/* Background fill: data phases repeat LCD_FillPattern instead of the buffer */
+static volatile uint8_t LCD_FlushFill = 0;
+static uint8_t LCD_FillPattern;
+/* Start line command sent after the last page of a background flush */
+static uint8_t LCD_FlushStartCmd;
+static volatile uint8_t LCD_FlushStartPending = 0;
+
+/* Frame statistics, a frame is one LCD_Flush or LCD_SwapBuffers */
+static LCD_FrameStats LCD_Stats;
+static uint32_t LCD_FrameStart;
+static volatile uint16_t LCD_FrameBytes;
+static uint8_t LCD_ProfilerOverlay = 0;
+
 /* Private function prototypes ------------------------------------------------*/
+static void LCD_MarkDirty(uint8_t page, uint8_t first, uint8_t last);
+static void LCD_MarkClean(uint8_t page);
+static uint8_t LCD_SendPageAddress(uint8_t x, uint8_t page);
+static void LCD_AdvanceCursor(uint8_t length);
+static void LCD_SendStartLine();
+static void LCD_AcquireBus();
+static void LCD_ReleaseBus();
+static void LCD_FlushAddressDone(SPI2_Status status);
+static void LCD_FlushNextPage(SPI2_Status status);
+static void LCD_ClearRamPage(uint8_t page);
+static void LCD_ApplyStartLine();
+static void LCD_FlushDirty();
+static void LCD_FrameBegin();
+static void LCD_FrameEnd();
+static uint8_t LCD_ProfilerClip(uint8_t page, uint8_t first, uint8_t *last);
+static void LCD_MarkProfilerArea();
+static void LCD_RestampProfiler();
+static void LCD_FormatNumber(char *text, uint8_t width, uint32_t value);
+static void LCD_DrawProfiler();
+
+/* Private functions ----------------------------------------------------------*/
+
+/**
+ * @fn LCD_MarkDirty
+ * @brief Extend the dirty column range of a page.
+ * @param page Page.
+ * @param first First dirty column.
+ * @param last Last dirty column.
+ */
+static void LCD_MarkDirty(uint8_t page, uint8_t first, uint8_t last) {
+	if (LCD_DirtyFirst[page] > LCD_DirtyLast[page]) {
+		LCD_DirtyFirst[page] = first;
+		LCD_DirtyLast[page] = last;
+		return;
+	}
+	if (first < LCD_DirtyFirst[page]) LCD_DirtyFirst[page] = first;
+	if (last > LCD_DirtyLast[page]) LCD_DirtyLast[page] = last;
+}
+
+/**
+ * @fn LCD_MarkClean
+ * @brief Mark a page as in sync with the display.
+ * @param page Page.
+ */
+static void LCD_MarkClean(uint8_t page) {
+	LCD_DirtyFirst[page] = LCD_Width;
+	LCD_DirtyLast[page] = 0;
+}
+
+/**
+ * @fn LCD_SendPageAddress
+ * @brief Set page and column of the display. The bus must be owned by the LCD.
+ * Only the commands that change the controller cursor are sent, if none is
+ * needed the C/D wire is not touched either.
+ * @param x Column.
+ * @param page Page.
+ * @return Number of command bytes sent, 0 to 3.
+ */
+static uint8_t LCD_SendPageAddress(uint8_t x, uint8_t page) {
+	uint8_t cmd[3];
+	uint8_t length = 0;
+
+	/* set page
+	 * C/D D7 D6 D5 D4 D3 D2 D1 D0
+	 * 0    1  0  1  1  0 A2 A1 A0
+	 *          0xB
+	 * followed by column upper and lower nibble
+	 */
+	if (page != LCD_CursorPage) {
+		cmd[length++] = 0xB0 | page;
+	}
+	if (x != LCD_CursorColumn) {
+		cmd[length++] = 0x10 | (x >> 4);
+		cmd[length++] = 0x00 | (0xF & x);
+	}
+	LCD_CursorPage = page;
+	LCD_CursorColumn = x;
+
+	if (length == 0) {
+		return 0;
+	}
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	SPI2_SendStream(cmd, length);
+	return length;
+}
+
+/**
+ * @fn LCD_AdvanceCursor
+ * @brief Follow the column auto-increment after data bytes were sent.
+ * @param length Number of data bytes sent.
+ */
+static void LCD_AdvanceCursor(uint8_t length) {
+	if (LCD_CursorColumn + length >= LCD_Width) {
+		LCD_CursorColumn = LCD_CURSOR_INVALID;
+		return;
+	}
+	LCD_CursorColumn += length;
+}
+
+/**
+ * @fn LCD_SendStartLine
+ * @brief Send the display start line of the current scroll offset. Does not
+ * move the controller cursor.
+ */
+static void LCD_SendStartLine() {
+	LCD_AcquireBus();
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	SPI2_SendData(0x40 | (LCD_PageOffset << 3));
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_AcquireBus
+ * @brief Own SPI2 for direct LCD access. Waits for a background flush first,
+ * its address and data phases must not be separated by other LCD writes.
+ * Calls may be nested. If the caller already owns the bus for the LCD
+ * through SPI2_Acquire, it keeps the ownership.
+ */
+static void LCD_AcquireBus() {
+	if (LCD_BusDepth++ > 0) {
+		return;
+	}
+	/* A flush cannot progress while the caller holds the bus */
+	if (SPI2_GetOwner() != SPI2_Device_LCD) {
+		LCD_WaitFlush();
+	}
+	LCD_BusAcquired = (SPI2_Acquire(SPI2_Device_LCD, HAL_MAX_DELAY) == SPI2_OK);
+}
+
+/**
+ * @fn LCD_ReleaseBus
+ * @brief Counterpart of LCD_AcquireBus. Releases the bus only if the
+ * outermost LCD_AcquireBus acquired it.
+ */
+static void LCD_ReleaseBus() {
+	if (LCD_BusDepth == 0 || --LCD_BusDepth > 0) {
+		return;
+	}
+	if (LCD_BusAcquired) {
+		LCD_BusAcquired = 0;
+		SPI2_Release(SPI2_Device_LCD);
+	}
+}
+
+/**
+ * @fn LCD_FlushAddressDone
+ * @brief Transaction callback of an address phase, only errors matter.
+ * @param status SPI2_OK or SPI2_Error.
+ */
+static void LCD_FlushAddressDone(SPI2_Status status) {
+	if (status != SPI2_OK) {
+		LCD_FlushFailed = 1;
+	}
+}
+
+/**
+ * @fn LCD_FlushNextPage
+ * @brief Queue address and data phase of the next dirty page of the front
+ * buffer. Called by LCD_SwapBuffers and from the SPI2 interrupt when the data
+ * phase of the previous page is complete. After a transfer error the flush is
+ * aborted, the rest of the frame is lost but LCD_WaitFlush returns.
+ * @param status SPI2_OK, or SPI2_Error if the previous transaction failed.
+ */
+static void LCD_FlushNextPage(SPI2_Status status) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (status != SPI2_OK || LCD_FlushFailed) {
+		LCD_FlushFailed = 0;
+		LCD_FlushPage = LCD_Pages;
+		/* Scroll with the next flush */
+		if (LCD_FlushStartPending) {
+			LCD_StartLinePending = 1;
+			LCD_FlushStartPending = 0;
+		}
+		LCD_FlushStalled = 0;
+		LCD_FlushBusy = 0;
+		/* The controller cursor is unknown, see LCD_SendPageAddress */
+		LCD_CursorPage = LCD_CURSOR_INVALID;
+		LCD_CursorColumn = LCD_CURSOR_INVALID;
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	/* Scroll before the content is sent, the pages are drawn for the new
+	 * start line and the exposed pages are cleared while off their old place */
+	if (LCD_FlushStartPending) {
+		SPI2_Transaction start = {
+			.Device = SPI2_Device_LCD,
+			.CD = SPI2_CD_Command,
+			.Data = &LCD_FlushStartCmd,
+			.Length = 1,
+			.Priority = SPI2_Priority_High,
+			.Callback = LCD_FlushNextPage
+		};
+		SPI2_Status queued = SPI2_Enqueue(&start);
+		if (queued == SPI2_Busy) {
+			/* LCD_WaitFlush and LCD_IsFlushBusy retry */
+			LCD_FlushStalled = 1;
+			__set_PRIMASK(primask);
+			return;
+		}
+		if (queued != SPI2_OK) {
+			__set_PRIMASK(primask);
+			LCD_FlushNextPage(SPI2_Error);
+			return;
+		}
+		LCD_FlushStalled = 0;
+		LCD_FlushStartPending = 0;
+		LCD_FrameBytes += 1;
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	/* Skip clean pages */
+	while (LCD_FlushPage < LCD_Pages && LCD_FlushFirst[LCD_FlushPage] > LCD_FlushLast[LCD_FlushPage]) {
+		LCD_FlushPage++;
+	}
+	if (LCD_FlushPage >= LCD_Pages) {
+		LCD_FrameEnd();
+		LCD_FlushBusy = 0;
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	/* Both phases are queued together or not at all, LCD_WaitFlush and
+	 * LCD_IsFlushBusy retry */
+	if (SPI2_QUEUE_SIZE - SPI2_GetQueueDepth() < 2) {
+		LCD_FlushStalled = 1;
+		__set_PRIMASK(primask);
+		return;
+	}
+	LCD_FlushStalled = 0;
+
+	uint8_t page = LCD_FlushPage++;
+	uint8_t first = LCD_FlushFirst[page];
+	LCD_FlushCmd[0] = 0xB0 | page;
+	LCD_FlushCmd[1] = 0x10 | (first >> 4);
+	LCD_FlushCmd[2] = 0x00 | (0xF & first);
+
+	SPI2_Transaction address = {
+		.Device = SPI2_Device_LCD,
+		.CD = SPI2_CD_Command,
+		.Data = LCD_FlushCmd,
+		.Length = 3,
+		.Priority = SPI2_Priority_High,
+		.Callback = LCD_FlushAddressDone
+	};
+	SPI2_Transaction data = {
+		.Device = SPI2_Device_LCD,
+		.CD = SPI2_CD_Data,
+		.Data = &LCD_FrontBuffer[page][first],
+		.Length = LCD_FlushLast[page] - first + 1,
+		.Priority = SPI2_Priority_High,
+		.Callback = LCD_FlushNextPage
+	};
+	if (LCD_FlushFill) {
+		data.Data = &LCD_FillPattern;
+		data.Repeat = 1;
+	}
+	/* Free slots were checked, a failure here means the transaction itself
+	 * is invalid: give up the frame instead of retrying forever */
+	if (SPI2_Enqueue(&address) != SPI2_OK) {
+		__set_PRIMASK(primask);
+		LCD_FlushNextPage(SPI2_Error);
+		return;
+	}
+	if (SPI2_Enqueue(&data) != SPI2_OK) {
+		/* The queued address phase completes without a data phase */
+		__set_PRIMASK(primask);
+		LCD_FlushNextPage(SPI2_Error);
+		return;
+	}
+	LCD_FrameBytes += address.Length + data.Length;
+
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @fn LCD_ClearRamPage
+ * @brief Clear a page of the display RAM, used for pages exposed by scrolling.
+ * @param page Display RAM page, not translated by the scroll offset.
+ */
+static void LCD_ClearRamPage(uint8_t page) {
+	memset(LCD_FrameBuffer[page], 0x00, LCD_Width);
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		LCD_MarkDirty(page, 0, LCD_Width - 1);
+		return;
+	}
+
+	uint8_t last = LCD_Width - 1;
+	LCD_MarkClean(page);
+	if (!LCD_ProfilerClip(page, 0, &last)) {
+		return;
+	}
+
+	LCD_AcquireBus();
+	LCD_SendPageAddress(0, page);
+	LCD_SetLCDMode(LCD_DATA_MODE);
+	SPI2_SendRepeated(0x00, last + 1);
+	LCD_AdvanceCursor(last + 1);
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_ApplyStartLine
+ * @brief Send the display start line of the current scroll offset, or defer
+ * it to the next flush in buffered mode.
+ */
+static void LCD_ApplyStartLine() {
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		LCD_StartLinePending = 1;
+		return;
+	}
+	LCD_SendStartLine();
+	LCD_StartLinePending = 0;
+}
+
+/**
+ * @fn LCD_FlushDirty
+ * @brief Send the dirty ranges of the RAM copy and a pending start line.
+ * Without frame accounting, e.g. when a drawing function leaves its
+ * temporary buffered mode. A background flush must not be running.
+ */
+static void LCD_FlushDirty() {
+	uint8_t page;
+
+	/* Scroll before the content is sent, see LCD_FlushNextPage */
+	if (LCD_StartLinePending) {
+		LCD_SendStartLine();
+		LCD_StartLinePending = 0;
+		LCD_FrameBytes += 1;
+	}
+
+	for (page = 0; page < LCD_Pages; page++) {
+		if (LCD_DirtyFirst[page] > LCD_DirtyLast[page]) {
+			continue;
+		}
+		uint8_t first = LCD_DirtyFirst[page];
+		uint8_t last = LCD_DirtyLast[page];
+		if (!LCD_ProfilerClip(page, first, &last)) {
+			LCD_MarkClean(page);
+			continue;
+		}
+		uint8_t length = last - first + 1;
+
+		LCD_AcquireBus();
+		LCD_FrameBytes += LCD_SendPageAddress(first, page) + length;
+		LCD_SetLCDMode(LCD_DATA_MODE);
+		SPI2_SendStream(&LCD_FrameBuffer[page][first], length);
+		LCD_AdvanceCursor(length);
+		LCD_ReleaseBus();
+
+		LCD_MarkClean(page);
+	}
+}
+
+/**
+ * @fn LCD_FrameBegin
+ * @brief Start the measurement of a frame, the time since the previous
+ * frame gives the frame rate.
+ */
+static void LCD_FrameBegin() {
+	uint32_t now = DWT_GetCycles();
+
+	if (LCD_Stats.Frames > 0) {
+		LCD_Stats.FrameCycles = now - LCD_FrameStart;
+		LCD_Stats.FPS = LCD_Stats.FrameCycles ? SystemCoreClock / LCD_Stats.FrameCycles : 0;
+	}
+	LCD_FrameStart = now;
+	LCD_FrameBytes = 0;
+}
+
+/**
+ * @fn LCD_FrameEnd
+ * @brief Complete the measurement of a frame. Called from the SPI2 interrupt
+ * at the end of a background flush.
+ */
+static void LCD_FrameEnd() {
+	LCD_Stats.FlushCycles = DWT_GetCycles() - LCD_FrameStart;
+	if (LCD_Stats.FlushCycles > LCD_Stats.FlushCyclesMax) {
+		LCD_Stats.FlushCyclesMax = LCD_Stats.FlushCycles;
+	}
+	LCD_Stats.Bytes = LCD_FrameBytes;
+	LCD_Stats.Frames++;
+}
+
+/**
+ * @fn LCD_ProfilerClip
+ * @brief Remove the columns covered by the profiler overlay from a dirty
+ * range, so the overlay is not overwritten and not counted.
+ * @param page Display RAM page.
+ * @param first First dirty column.
+ * @param last Last dirty column, reduced if it reaches the overlay.
+ * @return 1 if columns are left to send, 0 otherwise.
+ */
+static uint8_t LCD_ProfilerClip(uint8_t page, uint8_t first, uint8_t *last) {
+	uint8_t row = (page - LCD_PageOffset) & (LCD_Pages - 1);
+
+	if (!LCD_ProfilerOverlay || row >= LCD_PROFILER_ROWS || *last < LCD_PROFILER_X) {
+		return 1;
+	}
+	if (first >= LCD_PROFILER_X) {
+		return 0;
+	}
+	*last = LCD_PROFILER_X - 1;
+	return 1;
+}
+
+/**
+ * @fn LCD_MarkProfilerArea
+ * @brief Mark the screen content below the profiler overlay dirty, so the
+ * next flush restores it where the overlay is no longer shown.
+ */
+static void LCD_MarkProfilerArea() {
+	uint8_t row;
+
+	for (row = 0; row < LCD_PROFILER_ROWS; row++) {
+		LCD_MarkDirty(LCD_RAM_PAGE(row), LCD_PROFILER_X, LCD_Width - 1);
+	}
+}
+
+/**
+ * @fn LCD_RestampProfiler
+ * @brief Redraw the profiler overlay after it moved on the display, e.g. by
+ * scrolling. Direct mode sends the restored content and the overlay at once,
+ * buffered mode redraws it with the next frame.
+ */
+static void LCD_RestampProfiler() {
+	if (!LCD_ProfilerOverlay || LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		return;
+	}
+	LCD_FlushDirty();
+	LCD_DrawProfiler();
+}
+
+/**
+ * @fn LCD_FormatNumber
+ * @brief Right align a number in a text field, saturated to its width.
+ * @param text Text field.
+ * @param width Width of the field.
+ * @param value Value.
+ */
+static void LCD_FormatNumber(char *text, uint8_t width, uint32_t value) {
+	uint32_t limit = 1;
+	uint8_t i;
+
+	for (i = 0; i < width; i++) limit *= 10;
+	if (value >= limit) value = limit - 1;
+
+	for (i = width; i > 0; i--) {
+		text[i - 1] = (value || i == width) ? '0' + value % 10 : ' ';
+		value /= 10;
+	}
+}
+
+/**
+ * @fn LCD_DrawProfiler
+ * @brief Draw frame rate, flush time and bytes of the last frame. The
+ * overlay is sent directly and bypasses the RAM copy, dirty tracking and
+ * frame statistics.
+ */
+static void LCD_DrawProfiler() {
+	char text[LCD_PROFILER_ROWS][LCD_PROFILER_COLUMNS + 1] = {"    fps", "     us", "      B"};
+	uint8_t data[6 * LCD_PROFILER_COLUMNS];
+	uint8_t row, i, j;
+
+	LCD_FormatNumber(text[0], 4, LCD_Stats.FPS);
+	LCD_FormatNumber(text[1], 5, LCD_Stats.FlushCycles / (SystemCoreClock / 1000000));
+	LCD_FormatNumber(text[2], 6, LCD_Stats.Bytes);
+
+	LCD_AcquireBus();
+	for (row = 0; row < LCD_PROFILER_ROWS; row++) {
+		for (i = 0; i < LCD_PROFILER_COLUMNS; i++) {
+			uint8_t c = (uint8_t)text[row][i];
+			for (j = 0; j < 6; j++) {
+				data[6 * i + j] = c == ' ' ? 0 : LCD_Font_Data(LCD_Font_6x7int, 6 * c + j);
+			}
+		}
+		LCD_SendPageAddress(LCD_PROFILER_X, LCD_RAM_PAGE(row));
+		LCD_SetLCDMode(LCD_DATA_MODE);
+		SPI2_SendStream(data, sizeof(data));
+		LCD_AdvanceCursor(sizeof(data));
+	}
+	LCD_ReleaseBus();
+}
+
 /* Functions ------------------------------------------------------------------*/
 
 
@@ -50,6 +609,16 @@ void LCD_Init() {
 	GPIO_InitStructure.Pin = LCD_BACKLIGHT_PIN;
 	HAL_GPIO_Init(LCD_BACKLIGHT_PORT, &GPIO_InitStructure);
 
+	/* Display RAM copy is in sync after the first clear */
+	for (uint8_t page = 0; page < LCD_Pages; page++) {
+		LCD_MarkClean(page);
+	}
+
+	/* The init sequence sets start line 0 */
+	LCD_PageOffset = 0;
+	LCD_StartLinePending = 0;
+	LCD_InvalidateCursor();
+
 	/* Reset LCD */
 	LCD_Reset();
 
@@ -78,6 +647,7 @@ void LCD_Init() {
  */
 void LCD_Reset() {
 	HAL_GPIO_WritePin(LCD_NRST_PORT, LCD_NRST_PIN, GPIO_PIN_RESET);
+	LCD_InvalidateCursor();
 }
 
 /**
@@ -88,36 +658,40 @@ void LCD_UnReset() {
 	HAL_GPIO_WritePin(LCD_NRST_PORT, LCD_NRST_PIN, GPIO_PIN_SET);
 }
 
+/**
+ * @var LCD_PanelInit
+ * @brief Init sequence sent by LCD_ConfigDisplay. Defined weak, a panel
+ * variant can provide its own LCD_PanelInit in another file, or tune the
+ * defaults using LCD_INIT_BIAS, LCD_INIT_REGULATOR and LCD_INIT_CONTRAST.
+ */
+__weak const LCD_InitTable LCD_PanelInit = {
+	LCD_DefaultInitCommands,
+	sizeof(LCD_DefaultInitCommands)
+};
+
 /**
  * @fn LCD_ConfigDisplay
- * @brief Configure display for internal voltage generation
+ * @brief Configure display for internal voltage generation. The commands of
+ * LCD_PanelInit are sent in one command mode burst.
  */
 void LCD_ConfigDisplay() {
-	/* Display start line: Display start line 0 */
-	LCD_SendConfigData(0x40);
-	/* ADC set: ADC reverse */
-	LCD_SendConfigData(0xA1);
-	/* Common output mode select: Normal COM0~COM63  */
-	LCD_SendConfigData(0xC0);
-	/* Display normal: Display normal */
-	LCD_SendConfigData(0xA6);
-	/* LCD bias set: Set bias 1/9 (Duty 1/65) */
-	LCD_SendConfigData(0xA2);
-	/* Power control set: Booster, Regulator and Follower on*/
-	LCD_SendConfigData(0x2F);
-	/* Booster ratio set: Set internal booster to 4x*/
-	LCD_SendConfigData(0xF8);
-	LCD_SendConfigData(0x00);
-	/* V0 voltage regulator set: Contrast set */
-	LCD_SendConfigData(0x27);
-	/*  Electronic volume mode set: Contrast set */
-	LCD_SendConfigData(0x81);
-	LCD_SendConfigData(0x16);
-	/* Static indicator set: No indicator */
-	LCD_SendConfigData(0xAC);
-	LCD_SendConfigData(0x00);
-	/* Display ON/OFF: Display ON */
-	LCD_SendConfigData(0xAF);
+	LCD_SendCommands(LCD_PanelInit.Commands, LCD_PanelInit.Length);
+}
+
+/**
+ * @fn LCD_SendCommands
+ * @brief Send a sequence of commands to the display. C/D is set once and
+ * the bytes are streamed without gaps.
+ * @param commands Commands to send.
+ * @param length Number of command bytes.
+ */
+void LCD_SendCommands(const uint8_t *commands, uint16_t length) {
+	LCD_AcquireBus();
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	SPI2_SendStream(commands, length);
+	/* Commands may move the controller cursor */
+	LCD_InvalidateCursor();
+	LCD_ReleaseBus();
 }
 
 /**
@@ -126,9 +700,25 @@ void LCD_ConfigDisplay() {
  * @param data Configuration data to send.
  */
 void LCD_SendConfigData(uint8_t data) {
+	/* Own the bus, queued transfers must not toggle C/D */
+	LCD_AcquireBus();
 	/* Ensure command mode is enabled */
 	LCD_SetLCDMode(LCD_COMMAND_MODE);
 	SPI2_SendData(data);
+	/* Commands may move the controller cursor */
+	LCD_InvalidateCursor();
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_InvalidateCursor
+ * @brief Forget the tracked page/column of the controller, the next write
+ * sends the full address. Call after addressing the display without the
+ * functions of this file.
+ */
+void LCD_InvalidateCursor() {
+	LCD_CursorPage = LCD_CURSOR_INVALID;
+	LCD_CursorColumn = LCD_CURSOR_INVALID;
 }
 
 /**
@@ -155,13 +745,14 @@ void LCD_SetBacklightState(uint8_t state) {
  * @param mode
  */
 void LCD_SetLCDMode(LCD_MODE mode) {
+	/* The SPI driver owns the wire, it shares it with queued transfers */
 	if (mode == LCD_COMMAND_MODE) {
 		/* Set LCD to command mode */
-		HAL_GPIO_WritePin(LCD_CD_PORT, LCD_CD_PIN, GPIO_PIN_RESET);
+		SPI2_SetCD(SPI2_CD_Command);
 	}
 	else {
 		/* Set LCD to data mode */
-		HAL_GPIO_WritePin(LCD_CD_PORT, LCD_CD_PIN, GPIO_PIN_SET);
+		SPI2_SetCD(SPI2_CD_Data);
 	}
 }
 
@@ -173,37 +764,399 @@ void LCD_SetLCDMode(LCD_MODE mode) {
  * @param data Data to print.
  */
 void LCD_SetPageData(uint8_t x, uint8_t page, uint8_t data) {
-	/* Page boundaries check */
-	if (page > 7) {
+	/* Page and column boundaries check */
+	if (page > 7 || x >= LCD_Width) {
 		return;
 	}
 
-	/* Set page and column */
-	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	/* Logical page to display RAM page */
+	page = LCD_RAM_PAGE(page);
 
-	/* set page
-	 * C/D D7 D6 D5 D4 D3 D2 D1 D0
-	 * 0    1  0  1  1  0 A2 A1 A0
-	 *          0xB
-	 */
+	LCD_FrameBuffer[page][x] = data;
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		LCD_MarkDirty(page, x, x);
+		return;
+	}
 
-	uint8_t cmd = 0xB0 | page;
-	SPI2_SendData(cmd);
+	/* Below the profiler overlay only the RAM copy is updated */
+	uint8_t last = x;
+	if (!LCD_ProfilerClip(page, x, &last)) {
+		return;
+	}
 
-	/* Send column upper nibble */
-	cmd = 0x10 | (x >> 4);
-	SPI2_SendData(cmd);
+	/* Own the bus, queued transfers must not toggle C/D */
+	LCD_AcquireBus();
 
-	/* Send column lower nibble */
-	cmd = 0x00 | (0xF & x);
-	SPI2_SendData(cmd);
+	/* Set page and column */
+	LCD_SendPageAddress(x, page);
 
-	/* Send print data */
+	/* Send print data, the LCD stays in data mode for the next byte */
 	LCD_SetLCDMode(LCD_DATA_MODE);
 	SPI2_SendData(data);
+	LCD_AdvanceCursor(1);
 
-	/* Switch LCD back to command mode */
-	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_SetPageSpan
+ * @brief Write consecutive columns of a page. The page is addressed once and
+ * the data is streamed using the column auto-increment of the display.
+ * Nothing is sent if the RAM copy already holds the data.
+ * @param x First column.
+ * @param page Page.
+ * @param data Data to write, one byte per column.
+ * @param length Number of columns, clipped at the display edge.
+ */
+void LCD_SetPageSpan(uint8_t x, uint8_t page, const uint8_t *data, uint8_t length) {
+	if (page > 7 || x >= LCD_Width || length == 0) {
+		return;
+	}
+	if (length > LCD_Width - x) {
+		length = LCD_Width - x;
+	}
+
+	page = LCD_RAM_PAGE(page);
+	if (memcmp(&LCD_FrameBuffer[page][x], data, length) == 0) {
+		return;
+	}
+	memcpy(&LCD_FrameBuffer[page][x], data, length);
+
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		LCD_MarkDirty(page, x, x + length - 1);
+		return;
+	}
+
+	/* Below the profiler overlay only the RAM copy is updated */
+	uint8_t last = x + length - 1;
+	if (!LCD_ProfilerClip(page, x, &last)) {
+		return;
+	}
+	length = last - x + 1;
+
+	LCD_AcquireBus();
+	LCD_SendPageAddress(x, page);
+	LCD_SetLCDMode(LCD_DATA_MODE);
+	SPI2_SendStream(&LCD_FrameBuffer[page][x], length);
+	LCD_AdvanceCursor(length);
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_UpdateRect
+ * @brief Copy a bitmap to a region of the display, see LCD_Blit.
+ * @param x Left edge in pixels.
+ * @param y Top edge in pixels, need not be page aligned.
+ * @param w Width in pixels.
+ * @param h Height in pixels.
+ * @param src Bitmap in display format, (h + 7) / 8 page rows of w bytes.
+ */
+void LCD_UpdateRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *src) {
+	LCD_Blit(x, y, src, w, 0, 0, w, h);
+}
+
+/**
+ * @fn LCD_Blit
+ * @brief Copy a rectangle of a bitmap to the display. The bitmap is in display
+ * format: rows of pages, one byte per column holding 8 vertical pixels with
+ * the LSB on top, like the fonts. It may reside in RAM or flash.
+ * Every display page touched is addressed once and streamed in one burst,
+ * pixels outside the rectangle are kept. Page aligned rectangles are sent
+ * straight from the source.
+ * @param x Left edge on the display in pixels.
+ * @param y Top edge on the display in pixels.
+ * @param src Source bitmap.
+ * @param stride Bytes per page row of the source bitmap (its width).
+ * @param srcX Left edge in the source bitmap.
+ * @param srcY Top edge in the source bitmap.
+ * @param w Width in pixels.
+ * @param h Height in pixels.
+ */
+void LCD_Blit(uint8_t x, uint8_t y, const uint8_t *src, uint8_t stride,
+		uint8_t srcX, uint8_t srcY, uint8_t w, uint8_t h) {
+	uint8_t row[LCD_Width];
+	uint8_t page, column;
+
+	if (x >= LCD_Width || y >= LCD_Height || w == 0 || h == 0) {
+		return;
+	}
+	if (w > LCD_Width - x) w = LCD_Width - x;
+	if (h > LCD_Height - y) h = LCD_Height - y;
+
+	uint8_t firstPage = y >> 3;
+	uint8_t lastPage = (y + h - 1) >> 3;
+	uint8_t srcLastPage = (srcY + h - 1) >> 3;
+
+	/* Whole pages, no shifting or merging */
+	if (((y | srcY | h) & 7) == 0) {
+		for (page = firstPage; page <= lastPage; page++) {
+			LCD_SetPageSpan(x, page, &src[((srcY >> 3) + page - firstPage) * stride + srcX], w);
+		}
+		return;
+	}
+
+	for (page = firstPage; page <= lastPage; page++) {
+		/* Pixel rows of this page inside the rectangle */
+		int16_t top = (page << 3) < y ? y - (page << 3) : 0;
+		int16_t bottom = (page << 3) + 7 > y + h - 1 ? y + h - 1 - (page << 3) : 7;
+		uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (7 - bottom)));
+		/* Source row shown at bit 0 of this page, negative on the first page */
+		int16_t s = srcY + (page << 3) - y;
+
+		for (column = 0; column < w; column++) {
+			const uint8_t *col = &src[srcX + column];
+			uint8_t bits;
+
+			if (s < 0) {
+				bits = col[0] << (-s);
+			}
+			else {
+				uint8_t i = s >> 3;
+				uint8_t shift = s & 7;
+				bits = col[i * stride] >> shift;
+				if (shift && i + 1 <= srcLastPage) {
+					bits |= col[(i + 1) * stride] << (8 - shift);
+				}
+			}
+			row[column] = (LCD_GetPageData(x + column, page) & ~mask) | (bits & mask);
+		}
+		LCD_SetPageSpan(x, page, row, w);
+	}
+}
+
+/**
+ * @fn LCD_GetPageData
+ * @brief Read a byte of the display RAM copy.
+ * @param x Column.
+ * @param page Page.
+ * @return Data of the column, 0 if out of range.
+ */
+uint8_t LCD_GetPageData(uint8_t x, uint8_t page) {
+	if (page > 7 || x >= LCD_Width) {
+		return 0;
+	}
+	return LCD_FrameBuffer[LCD_RAM_PAGE(page)][x];
+}
+
+/**
+ * @fn LCD_SetDrawMode
+ * @brief Select whether drawing functions update the display immediately
+ * (LCD_DRAW_DIRECT) or only the RAM copy (LCD_DRAW_BUFFERED). In buffered
+ * mode LCD_Flush transmits the changes. Switching to direct mode sends the
+ * pending changes, this is not counted as frame.
+ * @param mode Draw mode.
+ */
+void LCD_SetDrawMode(LCD_DRAW_MODE mode) {
+	if (mode == LCD_DRAW_DIRECT) {
+		LCD_WaitFlush();
+		LCD_FlushDirty();
+	}
+	LCD_DrawMode = mode;
+}
+
+/**
+ * @fn LCD_SwapBuffers
+ * @brief Hand the frame drawn so far to a background flush and return
+ * immediately. The flush sends the dirty ranges page by page using DMA while
+ * the next frame is drawn. Waits if the previous flush is still running.
+ * The new back buffer starts as a copy of the frame being sent, so drawing
+ * can continue incrementally.
+ */
+void LCD_SwapBuffers() {
+	uint8_t page;
+	uint8_t (*buffer)[LCD_Width];
+
+	LCD_WaitFlush();
+
+	/* Swap, the drawn frame becomes the front buffer */
+	buffer = LCD_FrontBuffer;
+	LCD_FrontBuffer = LCD_FrameBuffer;
+	LCD_FrameBuffer = buffer;
+	memcpy(LCD_FrameBuffer, LCD_FrontBuffer, LCD_Pages * LCD_Width);
+
+	/* Overlay shows the previous frame, its flush is complete */
+	if (LCD_ProfilerOverlay) {
+		LCD_DrawProfiler();
+	}
+
+	for (page = 0; page < LCD_Pages; page++) {
+		LCD_FlushFirst[page] = LCD_DirtyFirst[page];
+		LCD_FlushLast[page] = LCD_DirtyLast[page];
+		if (LCD_FlushFirst[page] <= LCD_FlushLast[page] &&
+				!LCD_ProfilerClip(page, LCD_FlushFirst[page], &LCD_FlushLast[page])) {
+			LCD_FlushFirst[page] = LCD_Width;
+			LCD_FlushLast[page] = 0;
+		}
+		LCD_MarkClean(page);
+	}
+
+	LCD_FlushStartCmd = 0x40 | (LCD_PageOffset << 3);
+	LCD_FlushStartPending = LCD_StartLinePending;
+	LCD_StartLinePending = 0;
+
+	/* Queued address commands move the controller cursor */
+	LCD_InvalidateCursor();
+	LCD_FrameBegin();
+	LCD_FlushPage = 0;
+	LCD_FlushFill = 0;
+	LCD_FlushBusy = 1;
+	LCD_FlushNextPage(SPI2_OK);
+}
+
+/**
+ * @fn LCD_IsFlushBusy
+ * @brief Check if a background flush started by LCD_SwapBuffers is running.
+ * Continues a flush that stalled on a full SPI2 queue, so polling this is
+ * enough to complete it.
+ * @return 1 if busy, 0 otherwise.
+ */
+uint8_t LCD_IsFlushBusy() {
+	if (LCD_FlushBusy && LCD_FlushStalled) {
+		LCD_FlushNextPage(SPI2_OK);
+	}
+	return LCD_FlushBusy;
+}
+
+/**
+ * @fn LCD_WaitFlush
+ * @brief Wait for the background flush started by LCD_SwapBuffers.
+ * Must not be called from interrupt context.
+ */
+void LCD_WaitFlush() {
+	while (LCD_FlushBusy) {
+		/* SPI2 queue was full, queue the next page from here */
+		if (LCD_FlushStalled) {
+			LCD_FlushNextPage(SPI2_OK);
+		}
+	}
+}
+
+/**
+ * @fn LCD_GetDrawMode
+ * @brief Current draw mode, see LCD_SetDrawMode.
+ * @return Draw mode.
+ */
+LCD_DRAW_MODE LCD_GetDrawMode() {
+	return LCD_DrawMode;
+}
+
+/**
+ * @fn LCD_Flush
+ * @brief Transmit the dirty parts of the RAM copy. Every dirty page is
+ * addressed once, then its dirty column range is streamed using the column
+ * auto-increment of the display. Counts as a frame, see LCD_GetFrameStats.
+ */
+void LCD_Flush() {
+	LCD_WaitFlush();
+	LCD_FrameBegin();
+	LCD_FlushDirty();
+	LCD_FrameEnd();
+	if (LCD_ProfilerOverlay) {
+		LCD_DrawProfiler();
+	}
+}
+
+/**
+ * @fn LCD_GetFrameStats
+ * @brief Read the statistics of the last frame, i.e. the last LCD_Flush or
+ * LCD_SwapBuffers. The profiler overlay is not included.
+ * @param stats Destination of the statistics.
+ */
+void LCD_GetFrameStats(LCD_FrameStats *stats) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*stats = LCD_Stats;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @fn LCD_ResetFrameStats
+ * @brief Reset the frame statistics, e.g. when switching to another screen.
+ */
+void LCD_ResetFrameStats() {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	memset(&LCD_Stats, 0, sizeof(LCD_Stats));
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @fn LCD_SetProfilerOverlay
+ * @brief Show frame rate, flush time in us and bytes of the last frame in the
+ * top right corner. The overlay is redrawn after every frame, the screen
+ * content below it is not sent while it is shown, also not by direct
+ * drawing, and restored when it is switched off. Restoring is not counted as
+ * frame.
+ * @param state State >= 1 shows the overlay, 0 hides it.
+ */
+void LCD_SetProfilerOverlay(uint8_t state) {
+	LCD_ProfilerOverlay = (state >= 1);
+	if (LCD_ProfilerOverlay) {
+		return;
+	}
+
+	/* Restoring the content is not a frame of the application */
+	LCD_MarkProfilerArea();
+	if (LCD_DrawMode == LCD_DRAW_DIRECT) {
+		LCD_FlushDirty();
+	}
+}
+
+/**
+ * @fn LCD_ScrollUp
+ * @brief Scroll the display content up using the start line register of the
+ * display. Only the pages exposed at the bottom are cleared, the rest of the
+ * display RAM is not transmitted again. Page coordinates of all drawing
+ * functions follow the scroll, page 0 is always the top page.
+ * @param pages Number of pages to scroll.
+ */
+void LCD_ScrollUp(uint8_t pages) {
+	if (pages >= LCD_Pages) {
+		LCD_Fill(0x00);
+		return;
+	}
+
+	/* The overlay moves with the content, restore its old place */
+	if (LCD_ProfilerOverlay) {
+		LCD_MarkProfilerArea();
+	}
+
+	/* The top pages leave the display and come back as the bottom pages.
+	 * They are cleared after the start line moved them, so no blank band is
+	 * shown in place of the content still visible at the top. */
+	LCD_PageOffset = (LCD_PageOffset + pages) & (LCD_Pages - 1);
+	LCD_ApplyStartLine();
+	for (uint8_t page = LCD_Pages - pages; page < LCD_Pages; page++) {
+		LCD_ClearRamPage(LCD_RAM_PAGE(page));
+	}
+	LCD_RestampProfiler();
+}
+
+/**
+ * @fn LCD_ScrollDown
+ * @brief Scroll the display content down, see LCD_ScrollUp. The pages
+ * exposed at the top are cleared.
+ * @param pages Number of pages to scroll.
+ */
+void LCD_ScrollDown(uint8_t pages) {
+	if (pages >= LCD_Pages) {
+		LCD_Fill(0x00);
+		return;
+	}
+
+	/* The overlay moves with the content, restore its old place */
+	if (LCD_ProfilerOverlay) {
+		LCD_MarkProfilerArea();
+	}
+
+	/* The bottom pages leave the display and come back as the top pages,
+	 * cleared after the start line moved them like in LCD_ScrollUp */
+	LCD_PageOffset = (LCD_PageOffset - pages) & (LCD_Pages - 1);
+	LCD_ApplyStartLine();
+	for (uint8_t page = 0; page < pages; page++) {
+		LCD_ClearRamPage(LCD_RAM_PAGE(page));
+	}
+	LCD_RestampProfiler();
 }
 
 /**
@@ -214,6 +1167,11 @@ void LCD_Clear() {
 	int page = 0;
 	int column = 0;
 
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		LCD_ClearFast();
+		return;
+	}
+
 	for (page = 0; page < LCD_Pages; page++) {
 		for (column = 0; column < LCD_Width; column++) {
 			LCD_SetPageData(column, page, 0x0);
@@ -227,24 +1185,74 @@ void LCD_Clear() {
  * This implementation is much faster since the auto-foreward function of the
  * LCD is used. After a page and a column have been selected, the display automatically
  * selects the next column in the selected page. This reduces the overhead because less
- * control data must be transmitted.
+ * control data must be transmitted. Equivalent to LCD_Fill(0x00).
  */
 void LCD_ClearFast() {
-	int page = 0;
-	int column = 0;
+	LCD_Fill(0x00);
+}
 
-	for(page = 0; page < LCD_Pages; page++) {
-		for(column = 0; column < LCD_Width; column++) {
-			if(column == 0) {
-				LCD_SetPageData(column, page, 0x0);
-			}
-			else {
-				LCD_SetLCDMode(LCD_DATA_MODE);
-				SPI2_SendData(0x0);
-				LCD_SetLCDMode(LCD_COMMAND_MODE);
-			}
+/**
+ * @fn LCD_Fill
+ * @brief Fill the display with a byte pattern, e.g. 0x00 to clear or 0x55
+ * for horizontal lines. Each page is addressed once, then the LCD stays in
+ * data mode while 128 bytes of the pattern are streamed. Columns below the
+ * profiler overlay are only set in the RAM copy.
+ * @param pattern Byte written to every column of every page.
+ */
+void LCD_Fill(uint8_t pattern) {
+	uint8_t page;
+
+	memset(LCD_FrameBuffer, pattern, LCD_Pages * LCD_Width);
+	if (LCD_DrawMode == LCD_DRAW_BUFFERED) {
+		for (page = 0; page < LCD_Pages; page++) {
+			LCD_MarkDirty(page, 0, LCD_Width - 1);
 		}
+		return;
+	}
+
+	LCD_AcquireBus();
+	for (page = 0; page < LCD_Pages; page++) {
+		/* Same span as a flush of the whole page, the overlay is kept */
+		uint8_t last = LCD_Width - 1;
+		LCD_ProfilerClip(page, 0, &last);
+		LCD_SendPageAddress(0, page);
+		LCD_SetLCDMode(LCD_DATA_MODE);
+		SPI2_SendRepeated(pattern, last + 1);
+		LCD_AdvanceCursor(last + 1);
+		LCD_MarkClean(page);
 	}
+	LCD_ReleaseBus();
+}
+
+/**
+ * @fn LCD_Fill_DMA
+ * @brief Fill the display with a byte pattern in the background, like
+ * LCD_Fill. The DMA sends a single source byte with memory increment
+ * disabled. Returns immediately, use LCD_WaitFlush to wait for completion.
+ * Like LCD_Fill the profiler overlay is kept.
+ * @param pattern Byte written to every column of every page.
+ */
+void LCD_Fill_DMA(uint8_t pattern) {
+	uint8_t page;
+
+	LCD_WaitFlush();
+
+	memset(LCD_FrameBuffer, pattern, LCD_Pages * LCD_Width);
+	LCD_FillPattern = pattern;
+	for (page = 0; page < LCD_Pages; page++) {
+		LCD_FlushFirst[page] = 0;
+		LCD_FlushLast[page] = LCD_Width - 1;
+		LCD_ProfilerClip(page, 0, &LCD_FlushLast[page]);
+		LCD_MarkClean(page);
+	}
+
+	/* Queued address commands move the controller cursor */
+	LCD_InvalidateCursor();
+	LCD_FrameBegin();
+	LCD_FlushPage = 0;
+	LCD_FlushFill = 1;
+	LCD_FlushBusy = 1;
+	LCD_FlushNextPage(SPI2_OK);
 }
 
 /**
@@ -264,38 +1272,39 @@ void LCD_Flicker() {
  * @param state State >= 1 turns the LCD on. State == 0 turns the LCD off.
  */
 void LCD_OnOff(uint8_t state) {
+	LCD_AcquireBus();
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
 	if (state >= 1) {
 		SPI2_SendData(0xAF);
 	}
 	else {
 		SPI2_SendData(0xAE);
 	}
+	LCD_ReleaseBus();
 }
 
 /**
  * @fn LCD_PutPixel
- * @brief Put a single pixel on the LCD.
+ * @brief Put a single pixel on the LCD. The pixel is merged into the RAM copy
+ * of its column/page byte, other pixels of the byte are kept. Nothing is
+ * sent if the pixel is already set. In direct mode the byte is sent
+ * immediately, use buffered mode to send each byte once per frame.
  * @param x Pixel x-coordinate.
  * @param y Pixel y-coordinate.
  */
 void LCD_PutPixel(uint8_t x, uint8_t y) {
-	static uint8_t prev_x, prev_page, prevdata;
-
 	/* Page = Y/8 */
 	uint8_t page = y >> 3;
 
 	/* Pixel = Y%8 */
 	uint8_t pixel = y & 7;
 
-	uint8_t data = 1 << pixel;
-
-	if ((page == prev_page) && (x == prev_x)) {
-		prevdata |= data;
+	if (page >= LCD_Pages || x >= LCD_Width) {
+		return;
 	}
-	else {
-		prev_x = x;
-		prev_page = page;
-		prevdata = data;
+
+	uint8_t data = LCD_FrameBuffer[LCD_RAM_PAGE(page)][x] | (1 << pixel);
+	if (data != LCD_FrameBuffer[LCD_RAM_PAGE(page)][x]) {
+		LCD_SetPageData(x, page, data);
 	}
-	LCD_SetPageData(prev_x, prev_page, prevdata);
 }
@@ -20,6 +20,27 @@ typedef enum {
   LCD_DATA_MODE
 } LCD_MODE;
 
+typedef enum {
+  LCD_DRAW_DIRECT=0,	/* Every write is sent to the display */
+  LCD_DRAW_BUFFERED		/* Writes go to RAM, LCD_Flush sends them */
+} LCD_DRAW_MODE;
+
+/* Statistics of the last frame, cycles of the DWT cycle counter */
+typedef struct {
+  uint32_t Frames;			/* Frames since reset of the statistics */
+  uint32_t FlushCycles;		/* Duration of the last flush */
+  uint32_t FlushCyclesMax;	/* Longest flush */
+  uint32_t FrameCycles;		/* Time between the last two frames */
+  uint16_t FPS;				/* Frame rate derived from FrameCycles */
+  uint16_t Bytes;			/* Bytes sent by the last flush */
+} LCD_FrameStats;
+
+/* Command sequence sent once after reset, see LCD_PanelInit */
+typedef struct {
+  const uint8_t *Commands;
+  uint8_t Length;
+} LCD_InitTable;
+
 
 /* Public defines ------------------------------------------------------------*/
 #define LCD_BACKLIGHT_PIN 	GPIO_PIN_5
@@ -35,8 +56,21 @@ typedef enum {
 #define LCD_Height 			64
 #define LCD_Pages 			8
 
+/* Defaults of the built-in init table, may be set by the build to tune a panel */
+#ifndef LCD_INIT_BIAS
+#define LCD_INIT_BIAS		0xA2	/* Bias 1/9 */
+#endif
+#ifndef LCD_INIT_REGULATOR
+#define LCD_INIT_REGULATOR	0x27	/* V0 voltage regulator ratio */
+#endif
+#ifndef LCD_INIT_CONTRAST
+#define LCD_INIT_CONTRAST	0x16	/* Electronic volume, 0x00..0x3F */
+#endif
+
 /* Public macros -------------------------------------------------------------*/
 /* Public variables ----------------------------------------------------------*/
+extern const LCD_InitTable LCD_PanelInit;
+
 /* Public function prototypes ------------------------------------------------*/
 void LCD_Init();
 void LCD_Reset();
@@ -44,11 +78,31 @@ void LCD_UnReset();
 void LCD_SetBacklightState(uint8_t state);
 void LCD_SetLCDMode(LCD_MODE mode);
 void LCD_SetPageData(uint8_t X, uint8_t Page, uint8_t Data);
+void LCD_SetPageSpan(uint8_t x, uint8_t page, const uint8_t *data, uint8_t length);
+void LCD_UpdateRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *src);
+void LCD_Blit(uint8_t x, uint8_t y, const uint8_t *src, uint8_t stride,
+		uint8_t srcX, uint8_t srcY, uint8_t w, uint8_t h);
 void LCD_Clear();
 void LCD_PutPixel(uint8_t X, uint8_t Y);
 void LCD_ConfigDisplay();
+void LCD_SendCommands(const uint8_t *commands, uint16_t length);
 void LCD_SendConfigData(uint8_t Data);
+void LCD_InvalidateCursor();
 void LCD_OnOff(uint8_t state);
 void LCD_ClearFast();
+void LCD_Fill(uint8_t pattern);
+void LCD_Fill_DMA(uint8_t pattern);
+void LCD_GetFrameStats(LCD_FrameStats *stats);
+void LCD_ResetFrameStats();
+void LCD_SetProfilerOverlay(uint8_t state);
+void LCD_ScrollUp(uint8_t pages);
+void LCD_ScrollDown(uint8_t pages);
 void LCD_flicker();
+uint8_t LCD_GetPageData(uint8_t X, uint8_t Page);
+void LCD_SetDrawMode(LCD_DRAW_MODE mode);
+LCD_DRAW_MODE LCD_GetDrawMode();
+void LCD_Flush();
+void LCD_SwapBuffers();
+uint8_t LCD_IsFlushBusy();
+void LCD_WaitFlush();
 #endif
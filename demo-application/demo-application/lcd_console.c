@@ -0,0 +1,260 @@
+/********************************************************************************
+  * @file    	lcd_console.c
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Text console on the LCD, fed by printf through _write.
+  * 			A copy of the text grid is kept, so only cells whose
+  * 			character changed are sent. Scrolling uses the display
+  * 			start line, see LCD_ScrollUp.
+********************************************************************************/
+
+/* Includes -------------------------------------------------------------------*/
+#include <string.h>
+#include "lcd_console.h"
+#include "lcd_drawing.h"
+
+/* External variables ---------------------------------------------------------*/
+/* Private typedefs -----------------------------------------------------------*/
+/* Private defines ------------------------------------------------------------*/
+/* Underline below the 7 pixel high glyphs */
+#define LCD_CONSOLE_CURSOR	0x80
+
+/* Private macros -------------------------------------------------------------*/
+/* Private variables ----------------------------------------------------------*/
+static const uint8_t *LCD_Console_Font = 0;
+static char LCD_Console_Text[LCD_CONSOLE_ROWS][LCD_CONSOLE_COLUMNS];
+static uint8_t LCD_Console_Columns;
+static uint8_t LCD_Console_Column;
+static uint8_t LCD_Console_Row;
+static uint8_t LCD_Console_CursorVisible = 1;
+
+/* Private function prototypes ------------------------------------------------*/
+static void LCD_Console_DrawCell(uint8_t column, uint8_t row, uint8_t cursor);
+static void LCD_Console_Reset();
+static void LCD_Console_NewLine();
+static void LCD_Console_Emit(char c);
+
+/* Private functions ----------------------------------------------------------*/
+
+/**
+ * @fn LCD_Console_DrawCell
+ * @brief Render the character of a cell. LCD_SetPageSpan skips the transfer
+ * if the display already shows it.
+ * @param column Text column.
+ * @param row Text row.
+ * @param cursor 1 to underline the cell.
+ */
+static void LCD_Console_DrawCell(uint8_t column, uint8_t row, uint8_t cursor) {
+	uint8_t width = LCD_Font_Width(LCD_Console_Font);
+	uint8_t glyph[LCD_CONSOLE_MAX_FONT_WIDTH];
+	uint8_t c = (uint8_t)LCD_Console_Text[row][column];
+	uint8_t i;
+
+	if (c == ' ' || c < LCD_Font_CharsetOffset(LCD_Console_Font)) {
+		memset(glyph, 0, width);
+	}
+	else {
+		c -= LCD_Font_CharsetOffset(LCD_Console_Font);
+		for (i = 0; i < width; i++) {
+			glyph[i] = LCD_Font_Data(LCD_Console_Font, width * c + i);
+		}
+	}
+	if (cursor) {
+		for (i = 0; i < width; i++) {
+			glyph[i] |= LCD_CONSOLE_CURSOR;
+		}
+	}
+
+	LCD_SetPageSpan(column * width, row, glyph, width);
+}
+
+/**
+ * @fn LCD_Console_Reset
+ * @brief Clear text and display and move the cursor home without drawing it.
+ */
+static void LCD_Console_Reset() {
+	memset(LCD_Console_Text, ' ', sizeof(LCD_Console_Text));
+	LCD_Console_Column = 0;
+	LCD_Console_Row = 0;
+	LCD_ClearFast();
+}
+
+/**
+ * @fn LCD_Console_NewLine
+ * @brief Move the cursor to the start of the next row. On the last row the
+ * display is scrolled up by one page, only the new row is cleared.
+ */
+static void LCD_Console_NewLine() {
+	LCD_Console_Column = 0;
+	if (LCD_Console_Row < LCD_CONSOLE_ROWS - 1) {
+		LCD_Console_Row++;
+		return;
+	}
+
+	memmove(LCD_Console_Text[0], LCD_Console_Text[1],
+			(LCD_CONSOLE_ROWS - 1) * LCD_CONSOLE_COLUMNS);
+	memset(LCD_Console_Text[LCD_CONSOLE_ROWS - 1], ' ', LCD_CONSOLE_COLUMNS);
+	LCD_ScrollUp(1);
+}
+
+/**
+ * @fn LCD_Console_Emit
+ * @brief Process a character without drawing the cursor.
+ * @param c Character.
+ */
+static void LCD_Console_Emit(char c) {
+	switch (c) {
+	case '\n':
+		LCD_Console_NewLine();
+		return;
+	case '\r':
+		LCD_Console_Column = 0;
+		return;
+	case '\b':
+		if (LCD_Console_Column > 0) LCD_Console_Column--;
+		return;
+	case '\f':
+		LCD_Console_Reset();
+		return;
+	case '\t':
+		do {
+			LCD_Console_Emit(' ');
+		} while (LCD_Console_Column % LCD_CONSOLE_TAB);
+		return;
+	default:
+		break;
+	}
+
+	/* Wrap */
+	if (LCD_Console_Column >= LCD_Console_Columns) {
+		LCD_Console_NewLine();
+	}
+
+	if (LCD_Console_Text[LCD_Console_Row][LCD_Console_Column] != c) {
+		LCD_Console_Text[LCD_Console_Row][LCD_Console_Column] = c;
+		LCD_Console_DrawCell(LCD_Console_Column, LCD_Console_Row, 0);
+	}
+	LCD_Console_Column++;
+}
+
+/* Functions ------------------------------------------------------------------*/
+
+/**
+ * @fn LCD_Console_Init
+ * @brief Start the console, it uses the whole display. The LCD must be
+ * initialized. Afterwards printf output is shown on the display.
+ * @param Font Font with a width of up to LCD_CONSOLE_MAX_FONT_WIDTH pixels and
+ * one page per character, e.g. LCD_Font_6x7int or LCD_Font_6x7lcd.
+ * @return 0 on success, 1 if the font does not fit, the console is unchanged.
+ */
+uint8_t LCD_Console_Init(const uint8_t Font[]) {
+	if (Font == 0 || LCD_Font_Width(Font) == 0 ||
+			LCD_Font_Width(Font) > LCD_CONSOLE_MAX_FONT_WIDTH ||
+			LCD_Font_PagesPerChar(Font) != 1) {
+		return 1;
+	}
+
+	LCD_Console_Font = Font;
+	LCD_Console_Columns = LCD_Width / LCD_Font_Width(Font);
+	if (LCD_Console_Columns > LCD_CONSOLE_COLUMNS) {
+		LCD_Console_Columns = LCD_CONSOLE_COLUMNS;
+	}
+	LCD_Console_Clear();
+	return 0;
+}
+
+/**
+ * @fn LCD_Console_Stop
+ * @brief Detach the console from printf, output goes to __io_putchar again.
+ * The display content is kept, the LCD may be used for other things.
+ */
+void LCD_Console_Stop() {
+	LCD_Console_Font = 0;
+}
+
+/**
+ * @fn LCD_Console_Clear
+ * @brief Clear the display and move the cursor home.
+ */
+void LCD_Console_Clear() {
+	LCD_Console_Reset();
+	if (LCD_Console_CursorVisible) {
+		LCD_Console_DrawCell(0, 0, 1);
+	}
+}
+
+/**
+ * @fn LCD_Console_PutChar
+ * @brief Print a character at the cursor. Handles \\n, \\r, \\b, \\f and \\t,
+ * wraps at the end of a row.
+ * @param c Character.
+ */
+void LCD_Console_PutChar(char c) {
+	LCD_Console_Write(&c, 1);
+}
+
+/**
+ * @fn LCD_Console_Write
+ * @brief Print a buffer at the cursor, used by _write. The cursor is hidden
+ * while the buffer is processed and drawn once at the end.
+ * @param ptr Characters to print.
+ * @param len Number of characters.
+ * @return Number of characters consumed, -1 if the console is not started.
+ */
+int LCD_Console_Write(char *ptr, int len) {
+	int i;
+
+	if (LCD_Console_Font == 0) {
+		return -1;
+	}
+
+	if (LCD_Console_CursorVisible && LCD_Console_Column < LCD_Console_Columns) {
+		LCD_Console_DrawCell(LCD_Console_Column, LCD_Console_Row, 0);
+	}
+
+	for (i = 0; i < len; i++) {
+		LCD_Console_Emit(ptr[i]);
+	}
+
+	if (LCD_Console_CursorVisible && LCD_Console_Column < LCD_Console_Columns) {
+		LCD_Console_DrawCell(LCD_Console_Column, LCD_Console_Row, 1);
+	}
+	return len;
+}
+
+/**
+ * @fn LCD_Console_SetCursor
+ * @brief Move the cursor, e.g. to overwrite a status line in place.
+ * @param column Text column, clipped to the last column.
+ * @param row Text row, clipped to the last row.
+ */
+void LCD_Console_SetCursor(uint8_t column, uint8_t row) {
+	if (LCD_Console_Font == 0) {
+		return;
+	}
+	if (column >= LCD_Console_Columns) column = LCD_Console_Columns - 1;
+	if (row >= LCD_CONSOLE_ROWS) row = LCD_CONSOLE_ROWS - 1;
+
+	if (LCD_Console_CursorVisible && LCD_Console_Column < LCD_Console_Columns) {
+		LCD_Console_DrawCell(LCD_Console_Column, LCD_Console_Row, 0);
+	}
+	LCD_Console_Column = column;
+	LCD_Console_Row = row;
+	if (LCD_Console_CursorVisible) {
+		LCD_Console_DrawCell(column, row, 1);
+	}
+}
+
+/**
+ * @fn LCD_Console_ShowCursor
+ * @brief Show or hide the underline cursor.
+ * @param state State >= 1 shows the cursor, 0 hides it.
+ */
+void LCD_Console_ShowCursor(uint8_t state) {
+	LCD_Console_CursorVisible = (state >= 1);
+	if (LCD_Console_Font != 0 && LCD_Console_Column < LCD_Console_Columns) {
+		LCD_Console_DrawCell(LCD_Console_Column, LCD_Console_Row, LCD_Console_CursorVisible);
+	}
+}
@@ -0,0 +1,37 @@
+/********************************************************************************
+  * @file    	lcd_console.h
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Header file for lcd_console.c.
+********************************************************************************/
+
+#ifndef _lcd_console_h
+#define _lcd_console_h
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l4xx.h"
+#include "lcd.h"
+
+/* Public typedefs -----------------------------------------------------------*/
+/* Public defines ------------------------------------------------------------*/
+/* Text grid for 6 pixel wide fonts, one text row per page */
+#define LCD_CONSOLE_COLUMNS	(LCD_Width / 6)
+#define LCD_CONSOLE_ROWS	LCD_Pages
+#define LCD_CONSOLE_TAB		4
+/* Widest font accepted by LCD_Console_Init, fonts must be one page high */
+#define LCD_CONSOLE_MAX_FONT_WIDTH	8
+
+/* Public macros -------------------------------------------------------------*/
+/* Public variables ----------------------------------------------------------*/
+/* Public function prototypes ------------------------------------------------*/
+uint8_t LCD_Console_Init(const uint8_t Font[]);
+void LCD_Console_Stop();
+void LCD_Console_Clear();
+void LCD_Console_PutChar(char c);
+int LCD_Console_Write(char *ptr, int len);
+void LCD_Console_SetCursor(uint8_t column, uint8_t row);
+void LCD_Console_ShowCursor(uint8_t state);
+
+#endif
@@ -16,6 +16,9 @@
  ********************************************************************/
 
 /* Includes -------------------------------------------------------------------*/
+/* Keep LCD_Print a function here, see LCD_FONT_SUBSET */
+#define LCD_DRAWING_IMPL
+#include <string.h>
 #include "lcd.h"
 #include "lcd_drawing.h"
 #include "stm32l4xx.h"
@@ -26,43 +29,441 @@
 /* Private macros -------------------------------------------------------------*/
 /* Private variables ----------------------------------------------------------*/
 /* Private function prototypes ------------------------------------------------*/
+static void LCD_OrPageData(uint8_t X, uint8_t Page, uint8_t Mask);
+static uint8_t LCD_CircleSpan(uint8_t Radius, uint8_t Dx);
+static int LCD_PFont_Glyph(const LCD_PFont *Font, char C);
+static int8_t LCD_PFont_Kerning(const LCD_PFont *Font, char Left, char Right);
+static void LCD_FillColumns(int X, int Count, const int16_t Top[], const int16_t Bottom[],
+    const uint8_t Pattern[]);
+static void LCD_DrawCorners(int X0, int Y0, int X1, int Y1, uint8_t Radius);
+
+/* Public constants ----------------------------------------------------------*/
+/* 8x8 fill patterns, one byte per column (x & 7), LSB is the top pixel */
+const uint8_t LCD_Pattern_Solid[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+const uint8_t LCD_Pattern_Dark[8]  = {0xAA, 0xFF, 0x55, 0xFF, 0xAA, 0xFF, 0x55, 0xFF};
+const uint8_t LCD_Pattern_Gray[8]  = {0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA};
+const uint8_t LCD_Pattern_Light[8] = {0x55, 0x00, 0xAA, 0x00, 0x55, 0x00, 0xAA, 0x00};
+const uint8_t LCD_Pattern_Hatch[8] = {0x33, 0x66, 0xCC, 0x99, 0x33, 0x66, 0xCC, 0x99};
+
 /* Private functions ----------------------------------------------------------*/
 
+/**
+ * @fn LCD_OrPageData
+ * Set the pixels of a mask in a page byte, other pixels are kept.
+ * @param X Column.
+ * @param Page Page.
+ * @param Mask Pixels to set, LSB is the top pixel of the page.
+ */
+static void LCD_OrPageData(uint8_t X, uint8_t Page, uint8_t Mask) {
+  uint8_t v = LCD_GetPageData(X, Page);
+
+  if ((v | Mask) != v)
+    LCD_SetPageData(X, Page, v | Mask);
+}
+
+/**
+ * @fn LCD_PFont_Glyph
+ * Find the glyph of a code point in the range table of a proportional font.
+ * @param Font Proportional font.
+ * @param C Character.
+ * @return Glyph index, -1 if the font has no glyph for the character.
+ */
+static int LCD_PFont_Glyph(const LCD_PFont *Font, char C) {
+  uint8_t c = (uint8_t)C;
+  int i;
+
+  for (i = 0; i < Font->RangeCount; i++) {
+    if (c < Font->Ranges[i].First) break;
+    if (c <= Font->Ranges[i].Last) return Font->Ranges[i].Glyph + c - Font->Ranges[i].First;
+  }
+  return -1;
+}
+
+/**
+ * @fn LCD_PFont_Kerning
+ * Look up the kerning of a character pair.
+ * @param Font Proportional font.
+ * @param Left Left character.
+ * @param Right Right character.
+ * @return Columns to add between the pair.
+ */
+static int8_t LCD_PFont_Kerning(const LCD_PFont *Font, char Left, char Right) {
+  int i;
+
+  for (i = 0; i < Font->KerningCount; i++)
+    if (Font->Kerning[i].Left == Left && Font->Kerning[i].Right == Right)
+      return Font->Kerning[i].Adjust;
+  return 0;
+}
+
+/**
+ * @fn LCD_CircleSpan
+ * Half height of a circle at a horizontal distance from its center.
+ * @param Radius Radius in pixels.
+ * @param Dx Distance from the center, <= Radius.
+ * @return Largest dy inside the circle.
+ */
+static uint8_t LCD_CircleSpan(uint8_t Radius, uint8_t Dx) {
+  int r2 = Radius * Radius + Radius;
+  int dy = Radius;
+
+  while (dy > 0 && Dx * Dx + dy * dy > r2)
+    dy--;
+  return dy;
+}
+
+/**
+ * @fn LCD_FillColumns
+ * Fill a shape given by one vertical pixel span per column. The shape is
+ * written page by page, each page in a single run of one byte per column.
+ * Pixels of a span are replaced by the pattern, other pixels are kept.
+ * @param X First column, may be off screen.
+ * @param Count Number of columns.
+ * @param Top First row of each column span.
+ * @param Bottom Last row of each column span, < Top for an empty column.
+ * @param Pattern 8x8 pattern, NULL for solid.
+ */
+static void LCD_FillColumns(int X, int Count, const int16_t Top[], const int16_t Bottom[],
+    const uint8_t Pattern[]) {
+  uint8_t row[LCD_Width];
+  int first = 0, last = Count - 1, i, page, top = LCD_Height, bottom = -1;
+
+  /* Clip columns to the display */
+  if (X < 0) first = -X;
+  if (X + last >= LCD_Width) last = LCD_Width - 1 - X;
+  if (first > last) return;
+
+  for (i = first; i <= last; i++) {
+    if (Top[i] > Bottom[i]) continue;
+    if (Top[i] < top) top = Top[i];
+    if (Bottom[i] > bottom) bottom = Bottom[i];
+  }
+  if (top < 0) top = 0;
+  if (bottom >= LCD_Height) bottom = LCD_Height - 1;
+  if (top > bottom) return;
+
+  for (page = top >> 3; page <= bottom >> 3; page++) {
+    for (i = first; i <= last; i++) {
+      int x = X + i;
+      int t = Top[i] - (page << 3), b = Bottom[i] - (page << 3);
+      uint8_t v = LCD_GetPageData(x, page);
+
+      if (Top[i] <= Bottom[i] && t <= 7 && b >= 0) {
+        uint8_t mask = (uint8_t)((0xFF << (t < 0 ? 0 : t)) & (0xFF >> (7 - (b > 7 ? 7 : b))));
+        uint8_t pattern = Pattern ? Pattern[x & 7] : 0xFF;
+        v = (v & ~mask) | (pattern & mask);
+      }
+      row[i - first] = v;
+    }
+    LCD_SetPageSpan(X + first, page, row, last - first + 1);
+  }
+}
+
+/**
+ * @fn LCD_DrawCorners
+ * Draw the four quarter circles of a rounded rectangle.
+ * @param X0 Center x of the left corners.
+ * @param Y0 Center y of the top corners.
+ * @param X1 Center x of the right corners.
+ * @param Y1 Center y of the bottom corners.
+ * @param Radius Radius in pixels.
+ */
+static void LCD_DrawCorners(int X0, int Y0, int X1, int Y1, uint8_t Radius) {
+  int f = 1 - Radius;
+  int ddF_x = 1;
+  int ddF_y = -2 * Radius;
+  int dx = 0;
+  int dy = Radius;
+
+  while (dx <= dy) {
+    LCD_PutPixel(X1 + dx, Y1 + dy);
+    LCD_PutPixel(X0 - dx, Y1 + dy);
+    LCD_PutPixel(X1 + dx, Y0 - dy);
+    LCD_PutPixel(X0 - dx, Y0 - dy);
+    LCD_PutPixel(X1 + dy, Y1 + dx);
+    LCD_PutPixel(X0 - dy, Y1 + dx);
+    LCD_PutPixel(X1 + dy, Y0 - dx);
+    LCD_PutPixel(X0 - dy, Y0 - dx);
+
+    if (f >= 0) {
+      dy--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    dx++;
+    ddF_x += 2;
+    f += ddF_x;
+  }
+}
+
+/* Functions ------------------------------------------------------------------*/
+
 /**
  * @fn LCD_Print
- * Print a string.
+ * Print a string. The glyph columns of the whole string are collected per
+ * font page and sent in one burst, each page row is addressed once.
  * @param X X-Position.
  * @param StartPage Page / Line to start.
  * @param String String to print.
  * @param Font Font.
  */
 void LCD_Print(uint8_t X, uint8_t StartPage, char* String, const uint8_t Font[]) {
-  char c, v;
-  int Page, CharPos, CharXPos, CharOffs;
+  uint8_t row[LCD_Width];
+  uint8_t width = LCD_Font_Width(Font);
+  uint8_t pages = LCD_Font_PagesPerChar(Font);
+  uint16_t glyphSize = width * pages;
+  int Page, CharPos, CharXPos, Length;
+
+  if (X >= LCD_Width) return;
+
+  for (Page = 0; Page < pages; Page++) {
+    Length = 0;
+
+    for (CharPos = 0; String[CharPos] && X + Length < LCD_Width; CharPos++) {
+      /* Draw character unless it's a space */
+      /* Also take note that some fonts don't have this char */
+      if (String[CharPos] != 0x20) {
+        const uint8_t *v = &LCD_Font_Data(Font,
+            glyphSize * (uint8_t)(String[CharPos] - LCD_Font_CharsetOffset(Font)) + Page);
+
+        for (CharXPos = 0; CharXPos < width && X + Length < LCD_Width; CharXPos++, v += pages)
+          row[Length++] = *v;
+      }
+      else {
+        for (CharXPos = 0; CharXPos < width && X + Length < LCD_Width; CharXPos++)
+          row[Length++] = 0;
+      }
+    }
+
+    LCD_SetPageSpan(X, StartPage + Page, row, Length);
+  }
+}
+
+/**
+ * @fn LCD_PrintP
+ * Print a string using a proportional font. Like LCD_Print each page row is
+ * sent in one burst, but every glyph only takes its own width.
+ * @param X X-Position.
+ * @param StartPage Page / Line to start.
+ * @param String String to print.
+ * @param Font Proportional font, e.g. LCD_PFont_6x7int.
+ */
+void LCD_PrintP(uint8_t X, uint8_t StartPage, char* String, const LCD_PFont *Font) {
+  uint8_t row[LCD_Width];
+  int Page, CharPos, CharXPos, Pos, Length, Glyph, Width;
+
+  if (X >= LCD_Width) return;
+
+  for (Page = 0; Page < Font->PagesPerChar; Page++) {
+    memset(row, 0, sizeof(row));
+    Pos = 0;
+    Length = 0;
+
+    for (CharPos = 0; String[CharPos] && X + Pos < LCD_Width; CharPos++) {
+      if (CharPos > 0) {
+        Pos += LCD_PFont_Kerning(Font, String[CharPos - 1], String[CharPos]);
+        if (Pos < 0) Pos = 0;
+      }
+
+      Glyph = LCD_PFont_Glyph(Font, String[CharPos]);
+      Width = Glyph < 0 ? Font->SpaceWidth : LCD_PFont_GlyphWidth(Font, Glyph);
+
+      /* Kerned glyphs may overlap, merge their columns */
+      if (Glyph >= 0) {
+        const uint8_t *v = &LCD_PFont_Data(Font, Glyph, Page);
+        for (CharXPos = 0; CharXPos < Width && X + Pos + CharXPos < LCD_Width; CharXPos++, v += Font->PagesPerChar)
+          row[Pos + CharXPos] |= *v;
+      }
+
+      Pos += Width + Font->Spacing;
+      if (Pos > Length) Length = Pos;
+    }
+
+    if (X + Length > LCD_Width) Length = LCD_Width - X;
+    LCD_SetPageSpan(X, StartPage + Page, row, Length);
+  }
+}
+
+/**
+ * @fn LCD_PFont_TextWidth
+ * Width of a string printed with LCD_PrintP, e.g. to center or right align
+ * it. The spacing after the last glyph is not included.
+ * @param String String.
+ * @param Font Proportional font.
+ * @return Width in pixels, saturated at 255.
+ */
+uint8_t LCD_PFont_TextWidth(char* String, const LCD_PFont *Font) {
+  int CharPos, Glyph, Width = 0;
 
   for (CharPos = 0; String[CharPos]; CharPos++) {
-    /* Draw character unless it's a space */
-    if (String[CharPos] != 0x20) {
-      /* Determine offset into the data table for this character */
-      c = String[CharPos] - LCD_Font_CharsetOffset(Font);
-      CharOffs = LCD_Font_Width(Font) * LCD_Font_PagesPerChar(Font)*c;
-
-      for (CharXPos=0; (CharXPos < LCD_Font_Width(Font)) && (X < LCD_Width); CharXPos++, X++)
-        for (Page=0; Page < LCD_Font_PagesPerChar(Font); Page++) {
-          v = LCD_Font_Data(Font, CharOffs + CharXPos * LCD_Font_PagesPerChar(Font) + Page);
-          LCD_SetPageData(X, StartPage + Page, v);
-        }
+    if (CharPos > 0)
+      Width += Font->Spacing + LCD_PFont_Kerning(Font, String[CharPos - 1], String[CharPos]);
+    Glyph = LCD_PFont_Glyph(Font, String[CharPos]);
+    Width += Glyph < 0 ? Font->SpaceWidth : LCD_PFont_GlyphWidth(Font, Glyph);
+  }
+  return Width > 255 ? 255 : Width;
+}
+
+/**
+ * @fn LCD_RLE_Init
+ * Start decoding a run length encoded stream.
+ * @param Decoder Decoder state.
+ * @param Src Start of the stream.
+ */
+void LCD_RLE_Init(LCD_RLE_Decoder *Decoder, const uint8_t *Src) {
+  Decoder->Src = Src;
+  Decoder->Count = 0;
+  Decoder->Repeat = 0;
+}
+
+/**
+ * @fn LCD_RLE_Read
+ * Decode the next bytes of a run length encoded stream. Runs and literals
+ * are copied as blocks, a token may be split across calls.
+ * @param Decoder Decoder state.
+ * @param Dst Destination, NULL to skip the bytes.
+ * @param Length Number of bytes to decode.
+ */
+void LCD_RLE_Read(LCD_RLE_Decoder *Decoder, uint8_t *Dst, uint16_t Length) {
+  while (Length) {
+    if (Decoder->Count == 0) {
+      uint8_t token = *Decoder->Src++;
+      Decoder->Repeat = token & 0x80;
+      Decoder->Count = (token & 0x7F) + 1;
+    }
+
+    uint8_t n = Decoder->Count < Length ? Decoder->Count : Length;
+    if (Decoder->Repeat) {
+      if (Dst) memset(Dst, *Decoder->Src, n);
+      /* Value byte is consumed with the end of the run */
+      if (n == Decoder->Count) Decoder->Src++;
     }
     else {
-      /* It's a space, let's draw it a little faster */
-      /* Also take note that some fonts don't have this char */
-      for (CharXPos = 0; (CharXPos < LCD_Font_Width(Font)) && (X < LCD_Width); CharXPos++, X++)
-        for (Page = 0; Page < LCD_Font_PagesPerChar(Font); Page++)
-          LCD_SetPageData(X, StartPage+Page, 0);
+      if (Dst) memcpy(Dst, Decoder->Src, n);
+      Decoder->Src += n;
     }
 
-    /* Stop string output if end of display reached */
-    if (X >= LCD_Width) return;
+    Decoder->Count -= n;
+    Length -= n;
+    if (Dst) Dst += n;
+  }
+}
+
+/**
+ * @fn LCD_PrintC
+ * Print a string using a run length encoded font. The glyphs are decoded
+ * page by page straight into the burst of each page row, like LCD_Print.
+ * @param X X-Position.
+ * @param StartPage Page / Line to start.
+ * @param String String to print.
+ * @param Font Compressed font, e.g. LCD_CFont_21x28.
+ */
+void LCD_PrintC(uint8_t X, uint8_t StartPage, char* String, const LCD_CFont *Font) {
+  uint8_t row[LCD_Width];
+  LCD_RLE_Decoder decoder;
+  int Page, CharPos, Length, Width;
+
+  if (X >= LCD_Width) return;
+
+  for (Page = 0; Page < Font->PagesPerChar; Page++) {
+    Length = 0;
+
+    for (CharPos = 0; String[CharPos] && X + Length < LCD_Width; CharPos++) {
+      uint8_t c = (uint8_t)(String[CharPos] - Font->CharsetOffset);
+
+      Width = Font->Width;
+      if (X + Length + Width > LCD_Width) Width = LCD_Width - X - Length;
+
+      if (String[CharPos] == 0x20 || c >= Font->Count) {
+        memset(&row[Length], 0, Width);
+      }
+      else {
+        /* Skip the pages above, then decode this page of the glyph */
+        LCD_RLE_Init(&decoder, &Font->Data[Font->Offsets[c]]);
+        LCD_RLE_Read(&decoder, 0, Page * Font->Width);
+        LCD_RLE_Read(&decoder, &row[Length], Width);
+      }
+      Length += Width;
+    }
+
+    LCD_SetPageSpan(X, StartPage + Page, row, Length);
+  }
+}
+
+/**
+ * @fn LCD_DrawCBitmap
+ * Draw a run length encoded bitmap. The stream is decoded once, page by page,
+ * each page is sent in one burst.
+ * @param X X-Position.
+ * @param StartPage Page / Line to start.
+ * @param Bitmap Compressed bitmap.
+ */
+void LCD_DrawCBitmap(uint8_t X, uint8_t StartPage, const LCD_CBitmap *Bitmap) {
+  uint8_t row[LCD_Width];
+  LCD_RLE_Decoder decoder;
+  uint8_t visible = Bitmap->Width;
+  int Page;
+
+  if (X >= LCD_Width) return;
+  if (visible > LCD_Width - X) visible = LCD_Width - X;
+
+  LCD_RLE_Init(&decoder, Bitmap->Data);
+  for (Page = 0; Page < Bitmap->Pages; Page++) {
+    LCD_RLE_Read(&decoder, row, visible);
+    LCD_RLE_Read(&decoder, 0, Bitmap->Width - visible);
+    LCD_SetPageSpan(X, StartPage + Page, row, visible);
+  }
+}
+
+/**
+ * @fn LCD_PrintXY
+ * Print a string at any pixel position. Each glyph column is shifted across
+ * two display pages and merged with the content. Every display page the
+ * text touches is written in one burst.
+ * @param X X-Position in pixels.
+ * @param Y Y-Position of the top of the text in pixels.
+ * @param String String to print.
+ * @param Font Font.
+ * @param Mode LCD_TEXT_OR sets the glyph pixels only, LCD_TEXT_REPLACE also
+ * clears the background of the character cells.
+ */
+void LCD_PrintXY(uint8_t X, uint8_t Y, char* String, const uint8_t Font[], LCD_TEXT_MODE Mode) {
+  uint8_t row[LCD_Width];
+  uint8_t width = LCD_Font_Width(Font);
+  uint8_t pages = LCD_Font_PagesPerChar(Font);
+  uint16_t glyphSize = width * pages;
+  uint8_t shift = Y & 7;
+  int first = Y >> 3, Page, CharPos, CharXPos, Length;
+
+  if (X >= LCD_Width || Y >= LCD_Height) return;
+
+  /* A shifted glyph touches one page more than it has */
+  for (Page = first; Page <= first + pages - (shift ? 0 : 1) && Page < LCD_Pages; Page++) {
+    /* k: glyph page shifted down into this page, k - 1: glyph page above */
+    int k = Page - first;
+    uint8_t mask = (k < pages ? 0xFF << shift : 0) | (k > 0 && shift ? 0xFF >> (8 - shift) : 0);
+    Length = 0;
+
+    for (CharPos = 0; String[CharPos] && X + Length < LCD_Width; CharPos++) {
+      /* First column of the glyph, 0 for a space */
+      const uint8_t *v = 0;
+      if (String[CharPos] != 0x20)
+        v = &LCD_Font_Data(Font, glyphSize * (uint8_t)(String[CharPos] - LCD_Font_CharsetOffset(Font)));
+
+      for (CharXPos = 0; CharXPos < width && X + Length < LCD_Width; CharXPos++) {
+        uint8_t b = 0;
+        if (v) {
+          if (k < pages) b = v[k] << shift;
+          if (k > 0 && shift) b |= v[k - 1] >> (8 - shift);
+          v += pages;
+        }
+
+        uint8_t old = LCD_GetPageData(X + Length, Page);
+        row[Length++] = (Mode == LCD_TEXT_REPLACE) ? (old & ~mask) | b : old | b;
+      }
+    }
+
+    LCD_SetPageSpan(X, Page, row, Length);
   }
 }
 
@@ -75,6 +476,16 @@ void LCD_Print(uint8_t X, uint8_t StartPage, char* String, const uint8_t Font[])
  * @param YEnd Y-End position in pixels.
  */
 void LCD_DrawLine(uint8_t XStart, uint8_t YStart, uint8_t XEnd, uint8_t YEnd) {
+  /* Axis aligned lines are written as byte masks */
+  if (YStart == YEnd) {
+    LCD_DrawHLine(XStart, XEnd, YStart);
+    return;
+  }
+  if (XStart == XEnd) {
+    LCD_DrawVLine(XStart, YStart, YEnd);
+    return;
+  }
+
   // Non-C Standard: GCC nested function.
   // http://gcc.gnu.org/onlinedocs/gcc/Nested-Functions.html
   int sgn(int x){ return (x > 0) - (x < 0); }
@@ -104,7 +515,13 @@ void LCD_DrawLine(uint8_t XStart, uint8_t YStart, uint8_t XEnd, uint8_t YEnd) {
   y = YStart;
   err = el/2;
 
-  LCD_PutPixel(x, y);
+  /* Plot into RAM, send every touched byte once at the end */
+  LCD_DRAW_MODE mode = LCD_GetDrawMode();
+  LCD_SetDrawMode(LCD_DRAW_BUFFERED);
+
+  /* Collect the pixels of the current column/page byte, merge on change */
+  int bx = x, bpage = y >> 3;
+  uint8_t mask = 1 << (y & 7);
 
   for(t = 0; t < el; ++t) {
     err -= es;
@@ -119,8 +536,74 @@ void LCD_DrawLine(uint8_t XStart, uint8_t YStart, uint8_t XEnd, uint8_t YEnd) {
       y += pdy;
     }
 
-    LCD_PutPixel(x, y);
+    if (x != bx || (y >> 3) != bpage) {
+      LCD_OrPageData(bx, bpage, mask);
+      bx = x;
+      bpage = y >> 3;
+      mask = 0;
+    }
+    mask |= 1 << (y & 7);
    }
+  LCD_OrPageData(bx, bpage, mask);
+
+  LCD_SetDrawMode(mode);
+}
+
+/**
+ * @fn LCD_DrawHLine
+ * Draw a horizontal line. One mask is merged per column and the columns are
+ * sent in a single run.
+ * @param XStart X-Start position in pixels.
+ * @param XEnd X-End position in pixels.
+ * @param Y Y position in pixels.
+ */
+void LCD_DrawHLine(uint8_t XStart, uint8_t XEnd, uint8_t Y) {
+  uint8_t row[LCD_Width];
+  uint8_t mask = 1 << (Y & 7);
+  uint8_t page = Y >> 3;
+  int x;
+
+  if (XStart > XEnd) {
+    uint8_t t = XStart; XStart = XEnd; XEnd = t;
+  }
+  if (Y >= LCD_Height || XStart >= LCD_Width) return;
+  if (XEnd >= LCD_Width) XEnd = LCD_Width - 1;
+
+  for (x = XStart; x <= XEnd; x++)
+    row[x - XStart] = LCD_GetPageData(x, page) | mask;
+
+  LCD_SetPageSpan(XStart, page, row, XEnd - XStart + 1);
+}
+
+/**
+ * @fn LCD_DrawVLine
+ * Draw a vertical line. Whole pages are written as 0xFF, only the end
+ * pages are merged with a partial mask.
+ * @param X X position in pixels.
+ * @param YStart Y-Start position in pixels.
+ * @param YEnd Y-End position in pixels.
+ */
+void LCD_DrawVLine(uint8_t X, uint8_t YStart, uint8_t YEnd) {
+  int page, first, last;
+
+  if (YStart > YEnd) {
+    uint8_t t = YStart; YStart = YEnd; YEnd = t;
+  }
+  if (X >= LCD_Width || YStart >= LCD_Height) return;
+  if (YEnd >= LCD_Height) YEnd = LCD_Height - 1;
+
+  first = YStart >> 3;
+  last = YEnd >> 3;
+  for (page = first; page <= last; page++) {
+    uint8_t mask = 0xFF;
+    if (page == first) mask &= 0xFF << (YStart & 7);
+    if (page == last) mask &= 0xFF >> (7 - (YEnd & 7));
+
+    if (mask == 0xFF)
+      LCD_SetPageData(X, page, 0xFF);
+    else
+      LCD_OrPageData(X, page, mask);
+  }
 }
 
 /**
@@ -137,6 +620,10 @@ void LCD_DrawCircle(uint8_t X, uint8_t Y, uint8_t Radius) {
   int dx = 0;
   int dy = Radius;
 
+  /* Plot into RAM, send every touched byte once at the end */
+  LCD_DRAW_MODE mode = LCD_GetDrawMode();
+  LCD_SetDrawMode(LCD_DRAW_BUFFERED);
+
   LCD_PutPixel(X, Y + Radius);
   LCD_PutPixel(X, Y - Radius);
   LCD_PutPixel(X + Radius, Y);
@@ -162,4 +649,136 @@ void LCD_DrawCircle(uint8_t X, uint8_t Y, uint8_t Radius) {
     LCD_PutPixel(X + dy, Y - dx);
     LCD_PutPixel(X - dy, Y - dx);
   }
+
+  LCD_SetDrawMode(mode);
+}
+
+/**
+ * @fn LCD_DrawRect
+ * Draw the outline of a rectangle.
+ * @param X Left edge in pixels.
+ * @param Y Top edge in pixels.
+ * @param Width Width in pixels.
+ * @param Height Height in pixels.
+ */
+void LCD_DrawRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height) {
+  if (Width == 0 || Height == 0) return;
+  /* Keep the far edges within the uint8_t coordinate range */
+  if (X + Width > 256) Width = 256 - X;
+  if (Y + Height > 256) Height = 256 - Y;
+
+  LCD_DRAW_MODE mode = LCD_GetDrawMode();
+  LCD_SetDrawMode(LCD_DRAW_BUFFERED);
+
+  LCD_DrawHLine(X, X + Width - 1, Y);
+  LCD_DrawHLine(X, X + Width - 1, Y + Height - 1);
+  LCD_DrawVLine(X, Y, Y + Height - 1);
+  LCD_DrawVLine(X + Width - 1, Y, Y + Height - 1);
+
+  LCD_SetDrawMode(mode);
+}
+
+/**
+ * @fn LCD_FillRect
+ * Fill a rectangle with a pattern, e.g. for progress bars and panels.
+ * Costs one byte per column per page.
+ * @param X Left edge in pixels.
+ * @param Y Top edge in pixels.
+ * @param Width Width in pixels.
+ * @param Height Height in pixels.
+ * @param Pattern 8x8 pattern like LCD_Pattern_Gray, NULL for solid.
+ */
+void LCD_FillRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, const uint8_t Pattern[]) {
+  LCD_FillRoundRect(X, Y, Width, Height, 0, Pattern);
+}
+
+/**
+ * @fn LCD_DrawRoundRect
+ * Draw the outline of a rectangle with rounded corners.
+ * @param X Left edge in pixels.
+ * @param Y Top edge in pixels.
+ * @param Width Width in pixels.
+ * @param Height Height in pixels.
+ * @param Radius Corner radius in pixels, limited to half of the shorter side.
+ */
+void LCD_DrawRoundRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t Radius) {
+  if (Width == 0 || Height == 0) return;
+  /* Keep the far edges within the uint8_t coordinate range */
+  if (X + Width > 256) Width = 256 - X;
+  if (Y + Height > 256) Height = 256 - Y;
+  if (2 * Radius >= Width) Radius = (Width - 1) / 2;
+  if (2 * Radius >= Height) Radius = (Height - 1) / 2;
+  if (Radius == 0) {
+    LCD_DrawRect(X, Y, Width, Height);
+    return;
+  }
+
+  LCD_DRAW_MODE mode = LCD_GetDrawMode();
+  LCD_SetDrawMode(LCD_DRAW_BUFFERED);
+
+  int x1 = X + Width - 1, y1 = Y + Height - 1;
+  LCD_DrawHLine(X + Radius, x1 - Radius, Y);
+  LCD_DrawHLine(X + Radius, x1 - Radius, y1);
+  LCD_DrawVLine(X, Y + Radius, y1 - Radius);
+  LCD_DrawVLine(x1, Y + Radius, y1 - Radius);
+  LCD_DrawCorners(X + Radius, Y + Radius, x1 - Radius, y1 - Radius, Radius);
+
+  LCD_SetDrawMode(mode);
+}
+
+/**
+ * @fn LCD_FillRoundRect
+ * Fill a rectangle with rounded corners with a pattern.
+ * Costs one byte per column per page.
+ * @param X Left edge in pixels.
+ * @param Y Top edge in pixels.
+ * @param Width Width in pixels.
+ * @param Height Height in pixels.
+ * @param Radius Corner radius in pixels, limited to half of the shorter side.
+ * @param Pattern 8x8 pattern like LCD_Pattern_Gray, NULL for solid.
+ */
+void LCD_FillRoundRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t Radius,
+    const uint8_t Pattern[]) {
+  int16_t top[LCD_Width], bottom[LCD_Width];
+  int i, visible = Width;
+
+  if (Width == 0 || Height == 0 || X >= LCD_Width) return;
+  if (2 * Radius >= Width) Radius = (Width - 1) / 2;
+  if (2 * Radius >= Height) Radius = (Height - 1) / 2;
+  /* Corners follow the full width, only the visible columns are computed */
+  if (visible > LCD_Width - X) visible = LCD_Width - X;
+
+  for (i = 0; i < visible; i++) {
+    /* Distance into a corner from the straight part */
+    int d = 0;
+    if (i < Radius) d = Radius - i;
+    else if (i >= Width - Radius) d = i - (Width - 1 - Radius);
+    int inset = d ? Radius - LCD_CircleSpan(Radius, d) : 0;
+
+    top[i] = Y + inset;
+    bottom[i] = Y + Height - 1 - inset;
+  }
+  LCD_FillColumns(X, visible, top, bottom, Pattern);
+}
+
+/**
+ * @fn LCD_FillCircle
+ * Fill a circle with a pattern. Costs one byte per column per page.
+ * @param X Center x in pixels.
+ * @param Y Center y in pixels.
+ * @param Radius Radius in pixels.
+ * @param Pattern 8x8 pattern like LCD_Pattern_Gray, NULL for solid.
+ */
+void LCD_FillCircle(uint8_t X, uint8_t Y, uint8_t Radius, const uint8_t Pattern[]) {
+  int16_t top[2 * LCD_Width + 1], bottom[2 * LCD_Width + 1];
+  int dx;
+
+  if (Radius >= LCD_Width) Radius = LCD_Width - 1;
+
+  for (dx = -Radius; dx <= Radius; dx++) {
+    uint8_t h = LCD_CircleSpan(Radius, dx < 0 ? -dx : dx);
+    top[dx + Radius] = Y - h;
+    bottom[dx + Radius] = Y + h;
+  }
+  LCD_FillColumns(X - Radius, 2 * Radius + 1, top, bottom, Pattern);
 }
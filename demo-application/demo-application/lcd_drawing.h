@@ -23,6 +23,63 @@
 #include "lcd.h"
 
 /* Public typedefs -----------------------------------------------------------*/
+typedef enum {
+  LCD_TEXT_OR=0,	/* Set glyph pixels, keep the background */
+  LCD_TEXT_REPLACE	/* Glyph replaces the character cell */
+} LCD_TEXT_MODE;
+
+/* Proportional fonts, see LCD_PrintP. Glyphs are stored with their own
+ * width, only code points listed in the range table have a glyph. */
+typedef struct {
+  uint8_t First;		/* First code point of a run of defined glyphs */
+  uint8_t Last;			/* Last code point of the run */
+  uint16_t Glyph;		/* Glyph index of First */
+} LCD_PFontRange;
+
+typedef struct {
+  char Left;
+  char Right;
+  int8_t Adjust;		/* Columns added between the pair, usually negative */
+} LCD_PFontKerning;
+
+typedef struct {
+  uint8_t Height;		/* Pixels */
+  uint8_t PagesPerChar;
+  uint8_t Spacing;		/* Empty columns after each glyph */
+  uint8_t SpaceWidth;	/* Columns of ' ' and of code points without glyph */
+  uint8_t RangeCount;
+  uint8_t KerningCount;
+  const LCD_PFontRange *Ranges;	/* Sorted by code point */
+  const uint16_t *Offsets;	/* First column per glyph, one entry more than glyphs */
+  const uint8_t *Columns;	/* PagesPerChar bytes per column */
+  const LCD_PFontKerning *Kerning;
+} LCD_PFont;
+
+/* Run length encoded bitmaps and fonts, see LCD_DrawCBitmap and LCD_PrintC.
+ * The data is a stream of tokens: 0x00..0x7F n is followed by n + 1 literal
+ * bytes, 0x80..0xFF n is followed by one byte repeated (n & 0x7F) + 1 times.
+ * Images are stored page by page, all columns of the first page first. */
+typedef struct {
+  uint8_t Width;
+  uint8_t Pages;
+  const uint8_t *Data;
+} LCD_CBitmap;
+
+typedef struct {
+  uint8_t Width;
+  uint8_t PagesPerChar;
+  uint8_t CharsetOffset;
+  uint8_t Count;			/* Number of glyphs */
+  const uint16_t *Offsets;	/* Start of each glyph in Data, one entry more than glyphs */
+  const uint8_t *Data;
+} LCD_CFont;
+
+typedef struct {
+  const uint8_t *Src;
+  uint8_t Count;		/* Bytes left of the current token */
+  uint8_t Repeat;		/* Current token is a run */
+} LCD_RLE_Decoder;
+
 /* Public defines ------------------------------------------------------------*/
 #define LCD_Font_Width(f)         (f[0])
 #define LCD_Font_Height(f)        (f[1])
@@ -30,17 +87,52 @@
 #define LCD_Font_CharsetOffset(f) (f[3])
 #define LCD_Font_Data(f, x)       (f[4+x])
 
+#define LCD_PFont_GlyphOffset(f, g)	((f)->Offsets[g])
+#define LCD_PFont_GlyphWidth(f, g)	((f)->Offsets[(g) + 1] - (f)->Offsets[g])
+#define LCD_PFont_Data(f, g, x)		((f)->Columns[LCD_PFont_GlyphOffset(f, g) * (f)->PagesPerChar + (x)])
+
 /* Public macros -------------------------------------------------------------*/
 /* Public constants ----------------------------------------------------------*/
 extern const uint8_t LCD_Font_6x7int[];
 extern const uint8_t LCD_Font_6x7lcd[];
 extern const uint8_t LCD_Font_11x14[];
 extern const uint8_t LCD_Font_21x28[];
+extern const LCD_PFont LCD_PFont_6x7int;
+extern const LCD_CFont LCD_CFont_21x28;
+
+extern const uint8_t LCD_Pattern_Solid[8];
+extern const uint8_t LCD_Pattern_Dark[8];
+extern const uint8_t LCD_Pattern_Gray[8];
+extern const uint8_t LCD_Pattern_Light[8];
+extern const uint8_t LCD_Pattern_Hatch[8];
 
 /* Public variables ----------------------------------------------------------*/
 /* Public function prototypes ------------------------------------------------*/
 void LCD_Print(uint8_t X, uint8_t StartPage, char* String, const uint8_t Font[]);
+void LCD_PrintP(uint8_t X, uint8_t StartPage, char* String, const LCD_PFont *Font);
+uint8_t LCD_PFont_TextWidth(char* String, const LCD_PFont *Font);
+void LCD_PrintC(uint8_t X, uint8_t StartPage, char* String, const LCD_CFont *Font);
+void LCD_DrawCBitmap(uint8_t X, uint8_t StartPage, const LCD_CBitmap *Bitmap);
+void LCD_RLE_Init(LCD_RLE_Decoder *Decoder, const uint8_t *Src);
+void LCD_RLE_Read(LCD_RLE_Decoder *Decoder, uint8_t *Dst, uint16_t Length);
+void LCD_PrintXY(uint8_t X, uint8_t Y, char* String, const uint8_t Font[], LCD_TEXT_MODE Mode);
 void LCD_DrawLine(uint8_t XStart, uint8_t YStart, uint8_t XEnd, uint8_t YEnd);
+void LCD_DrawHLine(uint8_t XStart, uint8_t XEnd, uint8_t Y);
+void LCD_DrawVLine(uint8_t X, uint8_t YStart, uint8_t YEnd);
 void LCD_DrawCircle(uint8_t X, uint8_t Y, uint8_t Radius);
+void LCD_DrawRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height);
+void LCD_FillRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, const uint8_t Pattern[]);
+void LCD_DrawRoundRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t Radius);
+void LCD_FillRoundRect(uint8_t X, uint8_t Y, uint8_t Width, uint8_t Height, uint8_t Radius,
+    const uint8_t Pattern[]);
+void LCD_FillCircle(uint8_t X, uint8_t Y, uint8_t Radius, const uint8_t Pattern[]);
+
+/* Build time font subsets, see tools/font_subset.py. LCD_Print then uses the
+ * subset of the font if all strings printed with it are literals, the font
+ * argument must be the name of a font. */
+#if defined(LCD_FONT_SUBSET) && !defined(LCD_DRAWING_IMPL)
+#include "lcd_fonts_subset.h"
+#define LCD_Print(X, StartPage, String, Font)	LCD_Print_##Font(X, StartPage, String)
+#endif
 
 #endif
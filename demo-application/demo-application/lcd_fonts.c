@@ -17,6 +17,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32l4xx.h"
+#include "lcd_drawing.h"
 
 /* External variables --------------------------------------------------------*/
 /* Public typedefs -----------------------------------------------------------*/
@@ -1145,3 +1146,385 @@ const uint8_t LCD_Font_21x28[] =
 0x00, 0x00, 0x00, 0x00
 };
 
+
+/* Proportional version of LCD_Font_6x7int with all of its 221 non-empty
+ * glyphs, empty columns trimmed */
+static const uint8_t LCD_PFont_6x7int_Columns[] =
+{
+  0x4F,                            /* ! */
+  0x07, 0x00, 0x07,                /* " */
+  0x14, 0x7F, 0x14, 0x7F, 0x14,    /* # */
+  0x24, 0x2A, 0x7F, 0x2A, 0x12,    /* $ */
+  0x23, 0x13, 0x08, 0x64, 0x62,    /* % */
+  0x36, 0x49, 0x55, 0x22, 0x50,    /* & */
+  0x05, 0x03,                      /* ' */
+  0x1C, 0x22, 0x41,                /* ( */
+  0x41, 0x22, 0x1C,                /* ) */
+  0x14, 0x08, 0x3E, 0x08, 0x14,    /* asterisk */
+  0x08, 0x08, 0x3E, 0x08, 0x08,    /* + */
+  0x50, 0x30,                      /* , */
+  0x08, 0x08, 0x08, 0x08, 0x08,    /* - */
+  0x60, 0x60,                      /* . */
+  0x20, 0x10, 0x08, 0x04, 0x02,    /* slash */
+  0x3E, 0x51, 0x49, 0x45, 0x3E,    /* 0 */
+  0x42, 0x7F, 0x40,                /* 1 */
+  0x42, 0x61, 0x51, 0x49, 0x46,    /* 2 */
+  0x21, 0x41, 0x45, 0x4B, 0x31,    /* 3 */
+  0x18, 0x14, 0x12, 0x7F, 0x10,    /* 4 */
+  0x27, 0x45, 0x45, 0x45, 0x39,    /* 5 */
+  0x3C, 0x4A, 0x49, 0x49, 0x30,    /* 6 */
+  0x01, 0x71, 0x09, 0x05, 0x03,    /* 7 */
+  0x36, 0x49, 0x49, 0x49, 0x36,    /* 8 */
+  0x06, 0x49, 0x49, 0x29, 0x1E,    /* 9 */
+  0x36, 0x36,                      /* : */
+  0x56, 0x36,                      /* ; */
+  0x08, 0x14, 0x22, 0x41,          /* < */
+  0x14, 0x14, 0x14, 0x14, 0x14,    /* = */
+  0x41, 0x22, 0x14, 0x08,          /* > */
+  0x02, 0x01, 0x51, 0x09, 0x06,    /* ? */
+  0x32, 0x49, 0x79, 0x41, 0x3E,    /* @ */
+  0x7E, 0x11, 0x11, 0x11, 0x7E,    /* A */
+  0x7F, 0x49, 0x49, 0x49, 0x36,    /* B */
+  0x3E, 0x41, 0x41, 0x41, 0x22,    /* C */
+  0x7F, 0x41, 0x41, 0x22, 0x1C,    /* D */
+  0x7F, 0x49, 0x49, 0x49, 0x41,    /* E */
+  0x7F, 0x09, 0x09, 0x09, 0x01,    /* F */
+  0x3E, 0x41, 0x49, 0x49, 0x7A,    /* G */
+  0x7F, 0x08, 0x08, 0x08, 0x7F,    /* H */
+  0x41, 0x7F, 0x41,                /* I */
+  0x20, 0x40, 0x41, 0x3F, 0x01,    /* J */
+  0x7F, 0x08, 0x14, 0x22, 0x41,    /* K */
+  0x7F, 0x40, 0x40, 0x40, 0x40,    /* L */
+  0x7F, 0x02, 0x0C, 0x02, 0x7F,    /* M */
+  0x7F, 0x04, 0x08, 0x10, 0x7F,    /* N */
+  0x3E, 0x41, 0x41, 0x41, 0x3E,    /* O */
+  0x7F, 0x09, 0x09, 0x09, 0x06,    /* P */
+  0x3E, 0x41, 0x51, 0x21, 0x5E,    /* Q */
+  0x7F, 0x09, 0x19, 0x29, 0x46,    /* R */
+  0x46, 0x49, 0x49, 0x49, 0x31,    /* S */
+  0x01, 0x01, 0x7F, 0x01, 0x01,    /* T */
+  0x3F, 0x40, 0x40, 0x40, 0x3F,    /* U */
+  0x1F, 0x20, 0x40, 0x20, 0x1F,    /* V */
+  0x3F, 0x40, 0x30, 0x40, 0x3F,    /* W */
+  0x63, 0x14, 0x08, 0x14, 0x63,    /* X */
+  0x07, 0x08, 0x70, 0x08, 0x07,    /* Y */
+  0x61, 0x51, 0x49, 0x45, 0x43,    /* Z */
+  0x7F, 0x41, 0x41,                /* [ */
+  0x02, 0x04, 0x08, 0x10, 0x20,    /* \ */
+  0x41, 0x41, 0x7F,                /* ] */
+  0x04, 0x02, 0x01, 0x02, 0x04,    /* ^ */
+  0x40, 0x40, 0x40, 0x40, 0x40,    /* _ */
+  0x01, 0x02, 0x04,                /* ` */
+  0x20, 0x54, 0x54, 0x54, 0x78,    /* a */
+  0x7F, 0x48, 0x48, 0x48, 0x30,    /* b */
+  0x38, 0x44, 0x44, 0x44, 0x44,    /* c */
+  0x30, 0x48, 0x48, 0x48, 0x7F,    /* d */
+  0x38, 0x54, 0x54, 0x54, 0x58,    /* e */
+  0x08, 0x7E, 0x09, 0x02,          /* f */
+  0x48, 0x54, 0x54, 0x54, 0x3C,    /* g */
+  0x7F, 0x08, 0x08, 0x08, 0x70,    /* h */
+  0x7A,                            /* i */
+  0x20, 0x40, 0x40, 0x3D,          /* j */
+  0x7F, 0x10, 0x28, 0x44,          /* k */
+  0x41, 0x7F, 0x40,                /* l */
+  0x7C, 0x04, 0x38, 0x04, 0x7C,    /* m */
+  0x7C, 0x08, 0x04, 0x04, 0x78,    /* n */
+  0x38, 0x44, 0x44, 0x44, 0x38,    /* o */
+  0x7C, 0x14, 0x14, 0x14, 0x08,    /* p */
+  0x08, 0x14, 0x14, 0x14, 0x7C,    /* q */
+  0x7C, 0x08, 0x04, 0x04, 0x08,    /* r */
+  0x48, 0x54, 0x54, 0x54, 0x24,    /* s */
+  0x04, 0x04, 0x3F, 0x44, 0x24,    /* t */
+  0x3C, 0x40, 0x40, 0x40, 0x3C,    /* u */
+  0x1C, 0x20, 0x40, 0x20, 0x1C,    /* v */
+  0x3C, 0x40, 0x30, 0x40, 0x3C,    /* w */
+  0x44, 0x28, 0x10, 0x28, 0x44,    /* x */
+  0x04, 0x48, 0x30, 0x08, 0x04,    /* y */
+  0x44, 0x64, 0x54, 0x4C, 0x44,    /* z */
+  0x08, 0x36, 0x41, 0x41,          /* { */
+  0x77,                            /* | */
+  0x41, 0x41, 0x36, 0x08,          /* } */
+  0x04, 0x02, 0x02, 0x02, 0x01,    /* ~ */
+  0x15, 0x16, 0x7C, 0x16, 0x15,    /* 0x7F */
+  0x7D, 0x54, 0x54, 0x54, 0x45,    /* 0x80 */
+  0x04, 0x0A, 0x05,                /* 0x81 */
+  0x20, 0x44, 0x3E, 0x05, 0x02,    /* 0x82 */
+  0x21, 0x3F, 0x20, 0x00, 0x04,    /* 0x83 */
+  0x7F, 0x40, 0x40, 0x48, 0x40,    /* 0x84 */
+  0x38, 0x44, 0x28, 0x10, 0x6C,    /* 0x85 */
+  0x72, 0x7C, 0x06, 0x02, 0x02,    /* 0x86 */
+  0x30, 0x48, 0x4A, 0x4D, 0x38,    /* 0x87 */
+  0x10, 0x38, 0x54, 0x54, 0x54,    /* 0x88 */
+  0x1F, 0x02, 0x02, 0x3C, 0x40,    /* 0x89 */
+  0x3E, 0x49, 0x49, 0x3E,          /* 0x8A */
+  0x42, 0x22, 0x1C, 0x20, 0x40,    /* 0x8B */
+  0x04, 0x7C, 0x04, 0x7C, 0x44,    /* 0x8C */
+  0x08, 0x04, 0x3C, 0x44, 0x04,    /* 0x8D */
+  0x18, 0x24, 0x7E, 0x24, 0x18,    /* 0x8E */
+  0x38, 0x44, 0x30, 0x44, 0x38,    /* 0x8F */
+  0x41, 0x63, 0x55, 0x49, 0x41,    /* 0x90 */
+  0x5C, 0x62, 0x02, 0x62, 0x5C,    /* 0x91 */
+  0x2A, 0x2A, 0x2A, 0x2A, 0x2A,    /* 0x92 */
+  0x22, 0x14, 0x08, 0x14, 0x22,    /* 0x93 */
+  0x08, 0x08, 0x2A, 0x08, 0x08,    /* 0x94 */
+  0x0E, 0x11, 0x11, 0x0E,          /* 0x95 */
+  0x06, 0x09, 0x51, 0x01, 0x02,    /* 0x96 */
+  0x7F, 0x7F, 0x49, 0x49, 0x49,    /* 0x97 */
+  0x50, 0x58, 0x54, 0x52, 0x51,    /* 0x98 */
+  0x51, 0x52, 0x54, 0x58, 0x50,    /* 0x99 */
+  0x14, 0x34, 0x1C, 0x16, 0x14,    /* 0x9A */
+  0x20, 0x7F, 0x01, 0x01, 0x01,    /* 0x9B */
+  0x32, 0x49, 0x49, 0x3E,          /* 0x9C */
+  0x20, 0x40, 0x3E, 0x01, 0x02,    /* 0x9D */
+  0x1C, 0x22, 0x1C, 0x22, 0x1C,    /* 0x9E */
+  0x55, 0x2A, 0x55, 0x2A, 0x55,    /* 0x9F */
+  0x7D,                            /* 0xA1 */
+  0x1C, 0x22, 0x7F, 0x22,          /* 0xA2 */
+  0x48, 0x7E, 0x49, 0x49, 0x42,    /* 0xA3 */
+  0x5D, 0x22, 0x22, 0x22, 0x5D,    /* 0xA4 */
+  0x15, 0x16, 0x7C, 0x16, 0x15,    /* 0xA5 */
+  0x77,                            /* 0xA6 */
+  0x0A, 0x55, 0x55, 0x55, 0x28,    /* 0xA7 */
+  0x01, 0x00, 0x01,                /* 0xA8 */
+  0x3E, 0x5D, 0x55, 0x55, 0x3E,    /* 0xA9 */
+  0x48, 0x55, 0x55, 0x55, 0x5E,    /* 0xAA */
+  0x08, 0x14, 0x2A, 0x55, 0x22,    /* 0xAB */
+  0x01, 0x01, 0x01, 0x01, 0x03,    /* 0xAC */
+  0x3E, 0x55, 0x5D, 0x41, 0x3E,    /* 0xAE */
+  0x01, 0x01, 0x01, 0x01, 0x01,    /* 0xAF */
+  0x07, 0x05, 0x07,                /* 0xB0 */
+  0x44, 0x44, 0x5F, 0x44, 0x44,    /* 0xB1 */
+  0x12, 0x19, 0x15, 0x12,          /* 0xB2 */
+  0x15, 0x15, 0x0E,                /* 0xB3 */
+  0x02, 0x01,                      /* 0xB4 */
+  0x20, 0x1F, 0x08, 0x08, 0x07,    /* 0xB5 */
+  0x06, 0x7F, 0x01, 0x7F, 0x01,    /* 0xB6 */
+  0x08, 0x08,                      /* 0xB7 */
+  0x10, 0x00, 0x40, 0x20,          /* 0xB8 */
+  0x12, 0x1F, 0x10,                /* 0xB9 */
+  0x17, 0x15, 0x17,                /* 0xBA */
+  0x22, 0x55, 0x2A, 0x14, 0x08,    /* 0xBB */
+  0x0F, 0x20, 0x30, 0x28, 0x74,    /* 0xBC */
+  0x0F, 0x00, 0x48, 0x64, 0x58,    /* 0xBD */
+  0x7F, 0x7F, 0x7F, 0x7F, 0x7F,    /* 0xBE */
+  0x30, 0x48, 0x45, 0x40, 0x20,    /* 0xBF */
+  0x78, 0x15, 0x16, 0x14, 0x78,    /* 0xC0 */
+  0x78, 0x14, 0x16, 0x15, 0x78,    /* 0xC1 */
+  0x78, 0x15, 0x15, 0x15, 0x78,    /* 0xC2 */
+  0x79, 0x15, 0x15, 0x15, 0x79,    /* 0xC3 */
+  0x79, 0x14, 0x14, 0x14, 0x79,    /* 0xC4 */
+  0x78, 0x16, 0x15, 0x16, 0x78,    /* 0xC5 */
+  0x7E, 0x09, 0x7F, 0x49, 0x49,    /* 0xC6 */
+  0x0E, 0x51, 0x31, 0x11, 0x11,    /* 0xC7 */
+  0x7C, 0x55, 0x56, 0x54, 0x44,    /* 0xC8 */
+  0x7C, 0x54, 0x56, 0x55, 0x44,    /* 0xC9 */
+  0x7C, 0x55, 0x55, 0x55, 0x44,    /* 0xCA */
+  0x7D, 0x54, 0x54, 0x54, 0x45,    /* 0xCB */
+  0x45, 0x7E, 0x44,                /* 0xCC */
+  0x44, 0x7E, 0x45,                /* 0xCD */
+  0x45, 0x7D, 0x45,                /* 0xCE */
+  0x45, 0x7C, 0x45,                /* 0xCF */
+  0x08, 0x7F, 0x49, 0x41, 0x3E,    /* 0xD0 */
+  0x7D, 0x09, 0x11, 0x21, 0x7D,    /* 0xD1 */
+  0x38, 0x45, 0x46, 0x44, 0x38,    /* 0xD2 */
+  0x38, 0x44, 0x46, 0x45, 0x38,    /* 0xD3 */
+  0x38, 0x45, 0x45, 0x45, 0x38,    /* 0xD4 */
+  0x39, 0x45, 0x45, 0x45, 0x39,    /* 0xD5 */
+  0x39, 0x44, 0x44, 0x44, 0x39,    /* 0xD6 */
+  0x22, 0x14, 0x08, 0x14, 0x22,    /* 0xD7 */
+  0x5C, 0x32, 0x2A, 0x26, 0x1D,    /* 0xD8 */
+  0x3C, 0x41, 0x42, 0x40, 0x3C,    /* 0xD9 */
+  0x3C, 0x40, 0x42, 0x41, 0x3C,    /* 0xDA */
+  0x3C, 0x41, 0x41, 0x41, 0x3C,    /* 0xDB */
+  0x3D, 0x40, 0x40, 0x40, 0x3D,    /* 0xDC */
+  0x06, 0x08, 0x72, 0x09, 0x06,    /* 0xDD */
+  0x7F, 0x22, 0x22, 0x22, 0x1C,    /* 0xDE */
+  0x7E, 0x25, 0x25, 0x1A,          /* 0xDF */
+  0x20, 0x55, 0x56, 0x54, 0x78,    /* 0xE0 */
+  0x20, 0x54, 0x56, 0x55, 0x78,    /* 0xE1 */
+  0x20, 0x55, 0x55, 0x55, 0x78,    /* 0xE2 */
+  0x21, 0x55, 0x55, 0x55, 0x79,    /* 0xE3 */
+  0x20, 0x55, 0x54, 0x55, 0x78,    /* 0xE4 */
+  0x20, 0x56, 0x55, 0x56, 0x78,    /* 0xE5 */
+  0x74, 0x54, 0x38, 0x54, 0x5C,    /* 0xE6 */
+  0x0C, 0x52, 0x32, 0x12,          /* 0xE7 */
+  0x38, 0x55, 0x56, 0x54, 0x58,    /* 0xE8 */
+  0x38, 0x54, 0x56, 0x55, 0x58,    /* 0xE9 */
+  0x38, 0x55, 0x55, 0x55, 0x58,    /* 0xEA */
+  0x38, 0x55, 0x54, 0x55, 0x58,    /* 0xEB */
+  0x01, 0x7A,                      /* 0xEC */
+  0x7A, 0x01,                      /* 0xED */
+  0x02, 0x7A, 0x02,                /* 0xEE */
+  0x02, 0x78, 0x02,                /* 0xEF */
+  0x30, 0x48, 0x4A, 0x4D, 0x38,    /* 0xF0 */
+  0x7D, 0x09, 0x05, 0x05, 0x79,    /* 0xF1 */
+  0x30, 0x49, 0x4A, 0x48, 0x30,    /* 0xF2 */
+  0x30, 0x48, 0x4A, 0x49, 0x30,    /* 0xF3 */
+  0x30, 0x4A, 0x4A, 0x4A, 0x30,    /* 0xF4 */
+  0x32, 0x4A, 0x4A, 0x4A, 0x32,    /* 0xF5 */
+  0x30, 0x4A, 0x48, 0x4A, 0x30,    /* 0xF6 */
+  0x08, 0x08, 0x08, 0x2A, 0x08,    /* 0xF7 */
+  0x18, 0x64, 0x3C, 0x26, 0x18,    /* 0xF8 */
+  0x38, 0x41, 0x42, 0x40, 0x38,    /* 0xF9 */
+  0x38, 0x40, 0x42, 0x41, 0x38,    /* 0xFA */
+  0x38, 0x42, 0x42, 0x42, 0x38,    /* 0xFB */
+  0x38, 0x42, 0x40, 0x42, 0x38,    /* 0xFC */
+  0x04, 0x48, 0x32, 0x09, 0x04,    /* 0xFD */
+  0x7F, 0x12, 0x12, 0x0C,          /* 0xFE */
+  0x04, 0x49, 0x30, 0x09, 0x04,    /* 0xFF */
+};
+
+static const uint16_t LCD_PFont_6x7int_Offsets[] =
+{
+  0, 1, 4, 9, 14, 19, 24, 26, 29, 32, 37, 42,
+  44, 49, 51, 56, 61, 64, 69, 74, 79, 84, 89, 94,
+  99, 104, 106, 108, 112, 117, 121, 126, 131, 136, 141, 146,
+  151, 156, 161, 166, 171, 174, 179, 184, 189, 194, 199, 204,
+  209, 214, 219, 224, 229, 234, 239, 244, 249, 254, 259, 262,
+  267, 270, 275, 280, 283, 288, 293, 298, 303, 308, 312, 317,
+  322, 323, 327, 331, 334, 339, 344, 349, 354, 359, 364, 369,
+  374, 379, 384, 389, 394, 399, 404, 408, 409, 413, 418, 423,
+  428, 431, 436, 441, 446, 451, 456, 461, 466, 471, 475, 480,
+  485, 490, 495, 500, 505, 510, 515, 520, 525, 529, 534, 539,
+  544, 549, 554, 559, 563, 568, 573, 578, 579, 583, 588, 593,
+  598, 599, 604, 607, 612, 617, 622, 627, 632, 637, 640, 645,
+  649, 652, 654, 659, 664, 666, 670, 673, 676, 681, 686, 691,
+  696, 701, 706, 711, 716, 721, 726, 731, 736, 741, 746, 751,
+  756, 761, 764, 767, 770, 773, 778, 783, 788, 793, 798, 803,
+  808, 813, 818, 823, 828, 833, 838, 843, 848, 852, 857, 862,
+  867, 872, 877, 882, 887, 891, 896, 901, 906, 911, 913, 915,
+  918, 921, 926, 931, 936, 941, 946, 951, 956, 961, 966, 971,
+  976, 981, 986, 991, 995, 1000,
+};
+
+static const LCD_PFontRange LCD_PFont_6x7int_Ranges[] =
+{
+  {0x21, 0x9F, 0},
+  {0xA1, 0xAC, 127},
+  {0xAE, 0xFF, 139},
+};
+
+const LCD_PFont LCD_PFont_6x7int =
+{
+  .Height = 7,
+  .PagesPerChar = 1,
+  .Spacing = 1,
+  .SpaceWidth = 3,
+  .RangeCount = sizeof(LCD_PFont_6x7int_Ranges) / sizeof(LCD_PFontRange),
+  .KerningCount = 0,
+  .Ranges = LCD_PFont_6x7int_Ranges,
+  .Offsets = LCD_PFont_6x7int_Offsets,
+  .Columns = LCD_PFont_6x7int_Columns,
+  .Kerning = 0
+};
+
+/* LCD_Font_21x28 run length encoded, see LCD_CFont. Each glyph is stored
+ * page by page, all columns of page 0 first. */
+static const uint8_t LCD_CFont_21x28_Data[] =
+{
+/* 0 */
+0x05, 0xE0, 0xF8, 0xFC, 0xFE, 0x3F, 0x1F, 0x87, 0x0F, 0x06, 0x9F, 0xFF,
+0xFE, 0xFC, 0xF8, 0xE0, 0x00, 0x83, 0xFF, 0x0B, 0x00, 0x00, 0x80, 0xC0,
+0xE0, 0xF0, 0xF8, 0x7C, 0x3E, 0x1F, 0x0F, 0x07, 0x83, 0xFF, 0x01, 0x00,
+0x7F, 0x82, 0xFF, 0x05, 0xFE, 0x9F, 0x0F, 0x07, 0x03, 0x01, 0x82, 0x00,
+0x02, 0x80, 0xC0, 0xE0, 0x82, 0xFF, 0x05, 0x7F, 0x00, 0x00, 0x01, 0x03,
+0x07, 0x8B, 0x0F, 0x04, 0x07, 0x03, 0x01, 0x00, 0x00,
+/* 1 */
+0x83, 0x00, 0x03, 0x70, 0x78, 0x7C, 0x7E, 0x83, 0xFF, 0x90, 0x00, 0x83,
+0xFF, 0x90, 0x00, 0x83, 0xFF, 0x8C, 0x00, 0x8B, 0x0F, 0x84, 0x00,
+/* 2 */
+0x05, 0xE0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1F, 0x87, 0x0F, 0x05, 0x1F, 0x3E,
+0xFE, 0xFC, 0xF8, 0xE0, 0x89, 0x00, 0x19, 0x80, 0xC0, 0xE0, 0xF0, 0xF8,
+0xFC, 0x7E, 0x3F, 0x1F, 0x0F, 0x03, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0xF0,
+0xF8, 0xFC, 0x7E, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01, 0x86, 0x00, 0x93,
+0x0F, 0x00, 0x00,
+/* 3 */
+0x05, 0xF0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1F, 0x87, 0x0F, 0x05, 0x1F, 0x3E,
+0xFE, 0xFC, 0xF8, 0xE0, 0x8A, 0x00, 0x84, 0xF0, 0x06, 0xFC, 0xFF, 0xFF,
+0x9F, 0x07, 0x00, 0x70, 0x82, 0xF0, 0x01, 0xC0, 0x80, 0x87, 0x00, 0x01,
+0x80, 0xC3, 0x82, 0xFF, 0x06, 0x7E, 0x00, 0x00, 0x01, 0x03, 0x07, 0x07,
+0x89, 0x0F, 0x05, 0x07, 0x07, 0x03, 0x01, 0x00, 0x00,
+/* 4 */
+0x84, 0x00, 0x06, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0x7E, 0x83, 0xFF,
+0x84, 0x00, 0x0B, 0xF0, 0xF8, 0xFC, 0xFE, 0x3F, 0x1F, 0x0F, 0x07, 0x03,
+0x01, 0x00, 0x00, 0x83, 0xFF, 0x84, 0x00, 0x8B, 0x0F, 0x83, 0xFF, 0x83,
+0x0F, 0x8C, 0x00, 0x83, 0x0F, 0x84, 0x00,
+/* 5 */
+0x83, 0xFF, 0x8F, 0x0F, 0x00, 0x00, 0x8D, 0x0F, 0x07, 0x1F, 0x3E, 0xFE,
+0xFC, 0xF8, 0xE0, 0x00, 0x70, 0x82, 0xF0, 0x01, 0xC0, 0x80, 0x87, 0x00,
+0x01, 0x80, 0xC0, 0x82, 0xFF, 0x06, 0x7F, 0x00, 0x00, 0x01, 0x03, 0x07,
+0x07, 0x89, 0x0F, 0x05, 0x07, 0x07, 0x03, 0x01, 0x00, 0x00,
+/* 6 */
+0x05, 0xE0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1F, 0x87, 0x0F, 0x06, 0x1F, 0x3E,
+0xFE, 0xFC, 0xF8, 0xE0, 0x00, 0x83, 0xFF, 0x8A, 0xF0, 0x06, 0xE0, 0xE0,
+0xC0, 0x80, 0x00, 0x00, 0x7F, 0x82, 0xFF, 0x01, 0xC0, 0x80, 0x87, 0x00,
+0x01, 0x81, 0xC3, 0x82, 0xFF, 0x06, 0x7E, 0x00, 0x00, 0x01, 0x03, 0x07,
+0x07, 0x89, 0x0F, 0x05, 0x07, 0x07, 0x03, 0x01, 0x00, 0x00,
+/* 7 */
+0x8C, 0x0F, 0x02, 0x8F, 0xCF, 0xEF, 0x82, 0xFF, 0x00, 0x7F, 0x88, 0x00,
+0x09, 0xF0, 0xF8, 0xFC, 0xFE, 0x3F, 0x1F, 0x0F, 0x07, 0x03, 0x01, 0x8A,
+0x00, 0x83, 0xFF, 0x90, 0x00, 0x83, 0x0F, 0x88, 0x00,
+/* 8 */
+0x05, 0xE0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1F, 0x87, 0x0F, 0x0C, 0x1F, 0x3E,
+0xFE, 0xFC, 0xF8, 0xE0, 0x00, 0x07, 0x9F, 0xFF, 0xFF, 0xFC, 0xF8, 0x87,
+0xF0, 0x07, 0xF8, 0xFC, 0xFF, 0xFF, 0x9F, 0x0F, 0x00, 0x7E, 0x82, 0xFF,
+0x01, 0xC3, 0x81, 0x87, 0x00, 0x01, 0x81, 0xC3, 0x82, 0xFF, 0x06, 0x7E,
+0x00, 0x00, 0x01, 0x03, 0x07, 0x07, 0x89, 0x0F, 0x05, 0x07, 0x07, 0x03,
+0x01, 0x00, 0x00,
+/* 9 */
+0x05, 0xE0, 0xF8, 0xFC, 0xFE, 0x3E, 0x1F, 0x87, 0x0F, 0x0C, 0x1F, 0x3E,
+0xFE, 0xFC, 0xF8, 0xE0, 0x00, 0x07, 0x1F, 0x3F, 0x7F, 0x7C, 0xF8, 0x89,
+0xF0, 0x83, 0xFF, 0x01, 0x00, 0x70, 0x82, 0xF0, 0x01, 0xC0, 0x80, 0x87,
+0x00, 0x01, 0x80, 0xC0, 0x82, 0xFF, 0x06, 0x7F, 0x00, 0x00, 0x01, 0x03,
+0x07, 0x07, 0x89, 0x0F, 0x05, 0x07, 0x07, 0x03, 0x01, 0x00, 0x00,
+/* : */
+0x85, 0x00, 0x01, 0xC0, 0xE0, 0x83, 0xF0, 0x01, 0xE0, 0xC0, 0x8C, 0x00,
+0x01, 0x03, 0x07, 0x83, 0x0F, 0x01, 0x07, 0x03, 0x8C, 0x00, 0x01, 0x3C,
+0x7E, 0x83, 0xFF, 0x01, 0x7E, 0x3C, 0x9B, 0x00,
+/* ; */
+0x95, 0x00, 0x00, 0x80, 0x83, 0xC0, 0x02, 0x80, 0x00, 0x00, 0x87, 0xC0,
+0x83, 0x00, 0x82, 0xFF, 0x01, 0x01, 0x01, 0x82, 0xFF, 0x08, 0x00, 0x01,
+0x81, 0xE1, 0xF9, 0x7F, 0x1F, 0x07, 0x03, 0x83, 0x00, 0x08, 0x03, 0x07,
+0x0F, 0x0E, 0x0E, 0x0F, 0x07, 0x03, 0x00, 0x83, 0x0F, 0x83, 0x0E, 0x83,
+0x00,
+/* < */
+0x83, 0xFF, 0x83, 0x00, 0x0C, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC, 0x7E,
+0x3F, 0x1F, 0x0F, 0x07, 0x00, 0x00, 0x83, 0xFF, 0x08, 0xFC, 0xFC, 0xFE,
+0xFF, 0x9F, 0x0F, 0x07, 0x03, 0x01, 0x87, 0x00, 0x83, 0xFF, 0x0C, 0x03,
+0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7E, 0xFC, 0xF8, 0xF0, 0xE0, 0xC0, 0x80,
+0x83, 0x00, 0x83, 0x0F, 0x87, 0x00, 0x02, 0x01, 0x03, 0x07, 0x82, 0x0F,
+0x02, 0x0E, 0x00, 0x00,
+/* = */
+0x94, 0x00, 0x03, 0xF0, 0xF8, 0xFC, 0x3C, 0x84, 0x1C, 0x03, 0x3C, 0xFC,
+0xF8, 0xF0, 0x87, 0x00, 0x03, 0x83, 0x87, 0x0F, 0x0F, 0x84, 0x0E, 0x00,
+0x1F, 0x82, 0xFF, 0x87, 0x00, 0x02, 0x03, 0x07, 0x0F, 0x85, 0x0E, 0x03,
+0x0F, 0x0F, 0x07, 0x03, 0x87, 0x00,
+/* > */
+0x87, 0x00, 0x83, 0xF0, 0x88, 0x00, 0x87, 0xF0, 0x83, 0xFF, 0x87, 0xF0,
+0x88, 0x00, 0x83, 0xFF, 0x9D, 0x00,
+/* ? */
+0x95, 0x00, 0x00, 0x80, 0x83, 0xC0, 0x00, 0x80, 0x8D, 0x00, 0x03, 0x07,
+0x0F, 0x0F, 0x9F, 0x83, 0xFF, 0x00, 0x3C, 0x8B, 0x00, 0x06, 0x04, 0x0E,
+0x0F, 0x0F, 0x07, 0x03, 0x01, 0x8D, 0x00,
+/* @ */
+0x94, 0x00, 0x93, 0xF0, 0xAA, 0x00,
+/* A */
+0xA9, 0x00, 0x01, 0xC0, 0xE0, 0x83, 0xF0, 0x01, 0xE0, 0xC0, 0x8C, 0x00,
+0x01, 0x03, 0x07, 0x83, 0x0F, 0x01, 0x07, 0x03, 0x8C, 0x00,
+};
+
+static const uint16_t LCD_CFont_21x28_Offsets[] =
+{
+0, 69, 92, 143, 200, 243, 289, 347, 380, 443,
+502, 534, 583, 647, 689, 707, 738, 744, 766
+};
+
+const LCD_CFont LCD_CFont_21x28 =
+{
+  .Width = 21,
+  .PagesPerChar = 4,
+  .CharsetOffset = 0x30,
+  .Count = 18,
+  .Offsets = LCD_CFont_21x28_Offsets,
+  .Data = LCD_CFont_21x28_Data
+};
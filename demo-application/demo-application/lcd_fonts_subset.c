@@ -0,0 +1,85 @@
+/* Generated by tools/font_subset.py, do not edit. */
+
+#include "lcd_drawing.h"
+
+#ifdef LCD_FONT_SUBSET
+
+/* LCD_Font_6x7lcd subset: -128:ABCDEFIKLOPRSTWbcdehkmnorstux */
+static const uint8_t LCD_SFont_6x7lcd_Columns[] =
+{
+  0x08, 0x08, 0x08, 0x08, 0x08, 0x00, /* - */
+  0x00, 0x42, 0x7F, 0x40, 0x00, 0x00, /* 1 */
+  0x42, 0x61, 0x51, 0x49, 0x46, 0x00, /* 2 */
+  0x36, 0x49, 0x49, 0x49, 0x36, 0x00, /* 8 */
+  0x00, 0x36, 0x36, 0x00, 0x00, 0x00, /* : */
+  0x7E, 0x11, 0x11, 0x11, 0x7E, 0x00, /* A */
+  0x7F, 0x49, 0x49, 0x49, 0x36, 0x00, /* B */
+  0x3E, 0x41, 0x41, 0x41, 0x22, 0x00, /* C */
+  0x7F, 0x41, 0x41, 0x22, 0x1C, 0x00, /* D */
+  0x7F, 0x49, 0x49, 0x49, 0x41, 0x00, /* E */
+  0x7F, 0x09, 0x09, 0x09, 0x01, 0x00, /* F */
+  0x00, 0x41, 0x7F, 0x41, 0x00, 0x00, /* I */
+  0x7F, 0x08, 0x14, 0x22, 0x41, 0x00, /* K */
+  0x7F, 0x40, 0x40, 0x40, 0x40, 0x00, /* L */
+  0x3E, 0x41, 0x41, 0x41, 0x3E, 0x00, /* O */
+  0x7F, 0x09, 0x09, 0x09, 0x06, 0x00, /* P */
+  0x7F, 0x09, 0x19, 0x29, 0x46, 0x00, /* R */
+  0x46, 0x49, 0x49, 0x49, 0x31, 0x00, /* S */
+  0x01, 0x01, 0x7F, 0x01, 0x01, 0x00, /* T */
+  0x3F, 0x40, 0x38, 0x40, 0x3F, 0x00, /* W */
+  0x7F, 0x50, 0x48, 0x48, 0x30, 0x00, /* b */
+  0x38, 0x44, 0x44, 0x44, 0x20, 0x00, /* c */
+  0x30, 0x48, 0x48, 0x50, 0x7F, 0x00, /* d */
+  0x38, 0x54, 0x54, 0x54, 0x18, 0x00, /* e */
+  0x7F, 0x08, 0x04, 0x04, 0x78, 0x00, /* h */
+  0x7F, 0x10, 0x28, 0x44, 0x00, 0x00, /* k */
+  0x7C, 0x04, 0x18, 0x04, 0x78, 0x00, /* m */
+  0x7C, 0x08, 0x04, 0x04, 0x78, 0x00, /* n */
+  0x38, 0x44, 0x44, 0x44, 0x38, 0x00, /* o */
+  0x7C, 0x08, 0x04, 0x04, 0x08, 0x00, /* r */
+  0x48, 0x54, 0x54, 0x54, 0x20, 0x00, /* s */
+  0x04, 0x3F, 0x44, 0x40, 0x20, 0x00, /* t */
+  0x3C, 0x40, 0x40, 0x20, 0x7C, 0x00, /* u */
+  0x44, 0x28, 0x10, 0x28, 0x44, 0x00, /* x */
+};
+
+static const uint16_t LCD_SFont_6x7lcd_Offsets[] =
+{
+  0, 6, 12, 18, 24, 30, 36, 42, 48, 54, 60, 66, 72, 78, 84, 90, 96, 102, 108, 114, 120, 126, 132, 138, 144, 150, 156, 162, 168, 174, 180, 186, 192, 198, 204
+};
+
+static const LCD_PFontRange LCD_SFont_6x7lcd_Ranges[] =
+{
+  {0x2D, 0x2D, 0},
+  {0x31, 0x32, 1},
+  {0x38, 0x38, 3},
+  {0x3A, 0x3A, 4},
+  {0x41, 0x46, 5},
+  {0x49, 0x49, 11},
+  {0x4B, 0x4C, 12},
+  {0x4F, 0x50, 14},
+  {0x52, 0x54, 16},
+  {0x57, 0x57, 19},
+  {0x62, 0x65, 20},
+  {0x68, 0x68, 24},
+  {0x6B, 0x6B, 25},
+  {0x6D, 0x6F, 26},
+  {0x72, 0x75, 29},
+  {0x78, 0x78, 33},
+};
+
+const LCD_PFont LCD_SFont_6x7lcd =
+{
+  .Height = 7,
+  .PagesPerChar = 1,
+  .Spacing = 0,
+  .SpaceWidth = 6,
+  .RangeCount = 16,
+  .KerningCount = 0,
+  .Ranges = LCD_SFont_6x7lcd_Ranges,
+  .Offsets = LCD_SFont_6x7lcd_Offsets,
+  .Columns = LCD_SFont_6x7lcd_Columns,
+  .Kerning = 0
+};
+
+#endif
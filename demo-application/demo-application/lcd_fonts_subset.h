@@ -0,0 +1,20 @@
+/* Generated by tools/font_subset.py, do not edit. */
+/* LCD_Print_<font> is selected by LCD_Print in lcd_drawing.h. */
+
+#ifndef _lcd_fonts_subset_h
+#define _lcd_fonts_subset_h
+
+/* LCD_Font_11x14: full font, not printed */
+#define LCD_Print_LCD_Font_11x14(X, P, S)	(LCD_Print)(X, P, S, LCD_Font_11x14)
+
+/* LCD_Font_21x28: full font, used at runtime */
+#define LCD_Print_LCD_Font_21x28(X, P, S)	(LCD_Print)(X, P, S, LCD_Font_21x28)
+
+/* LCD_Font_6x7int: full font, used at runtime */
+#define LCD_Print_LCD_Font_6x7int(X, P, S)	(LCD_Print)(X, P, S, LCD_Font_6x7int)
+
+/* LCD_Font_6x7lcd: 34 of 256 glyphs, about 358 instead of 1540 bytes */
+extern const LCD_PFont LCD_SFont_6x7lcd;
+#define LCD_Print_LCD_Font_6x7lcd(X, P, S)	LCD_PrintP(X, P, S, &LCD_SFont_6x7lcd)
+
+#endif
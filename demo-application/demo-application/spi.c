@@ -9,18 +9,138 @@
 
 /* Includes -------------------------------------------------------------------*/
 #include "spi.h"
+#include "dwt.h"
 
 /* External variables --------------------------------------------------------*/
 /* Private typedefs -----------------------------------------------------------*/
+typedef struct {
+	SPI2_Transaction Transaction;
+	uint32_t Sequence;
+	uint32_t EnqueueCycles;		/* DWT timestamp for the latency histogram */
+	uint16_t Offset;			/* Bytes already sent */
+	uint16_t Chunk;				/* Bytes of the chunk on the bus */
+	uint8_t Used;
+} SPI2_QueueSlot;
+
 /* Private defines ------------------------------------------------------------*/
 /* Private macros -------------------------------------------------------------*/
+/* Critical section usable from thread and interrupt context */
+#define SPI2_ENTER_CRITICAL()	uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define SPI2_EXIT_CRITICAL()	__set_PRIMASK(primask)
+
 /* Private variables ----------------------------------------------------------*/
-uint8_t SPI2_ChipSelectLocked = 1;
 SPI_HandleTypeDef hspi;
+DMA_HandleTypeDef hdma_spi2_tx;
+DMA_HandleTypeDef hdma_spi2_rx;
+
+/* Transaction queue, slots are served in order of their sequence number */
+static SPI2_QueueSlot SPI2_Queue[SPI2_QUEUE_SIZE];
+static uint32_t SPI2_QueueSequence = 0;
+static volatile uint8_t SPI2_QueueDepth = 0;
+static volatile uint8_t SPI2_QueueHighWatermark = 0;
+/* Slot currently transmitted by the DMA, -1 if the bus is idle */
+static volatile int8_t SPI2_QueueCurrent = -1;
+/* Queue processing is held off while > 0, see SPI2_SuspendQueue */
+static volatile uint8_t SPI2_QueueSuspended = 0;
+/* Callers waiting in SPI2_Acquire/SPI2_SuspendQueue. The queue stops at the
+ * next transaction or chunk boundary, otherwise a stream re-armed from its
+ * callback would never leave the bus idle. */
+static volatile uint8_t SPI2_AcquirePending = 0;
+/* Consecutive transactions started for the active device, see SPI2_QUEUE_MAX_BATCH */
+static uint8_t SPI2_QueueBatch = 0;
+/* Chunked transaction that has been started but not finished, -1 if none */
+static int8_t SPI2_QueuePartial = -1;
+/* Completion of the transaction queued by SPI2_SendBuffer */
+static volatile uint8_t SPI2_SendBufferDone = 0;
+
+/* Bus arbitration */
+static volatile SPI2_Device SPI2_Owner = SPI2_Device_None;
+static SPI2_Device SPI2_ActiveDevice = SPI2_Device_None;
+/* Instrumentation, see SPI2_GetStats */
+static SPI2_Stats SPI2_Statistics;
+/* Last state driven on the command/data wire */
+static SPI2_CDState SPI2_CDCurrent = SPI2_CD_Keep;
+
+/* Device profiles, applied whenever the chip select changes */
+static SPI2_DeviceConfig SPI2_Devices[SPI2_Device_None] = {
+	/* ST7565R: tSCYC >= 50ns at 3.3V -> 80MHz / 4 = 20MHz, mode 0 */
+	[SPI2_Device_LCD] = {
+		.CSPort = SPI2_CS_LCD_PORT,
+		.CSPin = SPI2_CS_LCD_PIN,
+		.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_4,
+		.CLKPolarity = SPI_POLARITY_LOW,
+		.CLKPhase = SPI_PHASE_1EDGE,
+		.DataSize = SPI_DATASIZE_8BIT
+	},
+	/* Unknown peripheral: 80MHz / 8 = 10MHz, mode 0 */
+	[SPI2_Device_Plug] = {
+		.CSPort = SPI2_CS_PLUG_PORT,
+		.CSPin = SPI2_CS_PLUG_PIN,
+		.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8,
+		.CLKPolarity = SPI_POLARITY_LOW,
+		.CLKPhase = SPI_PHASE_1EDGE,
+		.DataSize = SPI_DATASIZE_8BIT
+	}
+};
 
 /* Private function prototypes ------------------------------------------------*/
+static void SPI2_DMA_Init();
+static void SPI2_ApplyProfile(const SPI2_DeviceConfig *config);
+static void SPI2_ApplyChipSelect(SPI2_Device device);
+static void SPI2_Queue_StartNext();
+static void SPI2_RecordCycles(uint32_t *histogram, uint32_t cycles);
+static void SPI2_SendBuffer_Complete(SPI2_Status status);
+
 /* Private functions ----------------------------------------------------------*/
 
+/**
+ * @fn SPI2_DMA_Init
+ * @brief Initialize the DMA channels used for SPI2 transmissions.
+ */
+static void SPI2_DMA_Init() {
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	hdma_spi2_tx.Instance = SPI2_TX_DMA_CHANNEL;
+	hdma_spi2_tx.Init.Request = SPI2_TX_DMA_REQUEST;
+	hdma_spi2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdma_spi2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_spi2_tx.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_spi2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_spi2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_spi2_tx.Init.Mode = DMA_NORMAL;
+	/* WS2812b timing is more critical, it keeps DMA_PRIORITY_HIGH */
+	hdma_spi2_tx.Init.Priority = DMA_PRIORITY_MEDIUM;
+	HAL_DMA_Init(&hdma_spi2_tx);
+
+	__HAL_LINKDMA(&hspi, hdmatx, hdma_spi2_tx);
+
+	/* Receive channel for full duplex transactions */
+	hdma_spi2_rx.Instance = SPI2_RX_DMA_CHANNEL;
+	hdma_spi2_rx.Init.Request = SPI2_RX_DMA_REQUEST;
+	hdma_spi2_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdma_spi2_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdma_spi2_rx.Init.MemInc = DMA_MINC_ENABLE;
+	hdma_spi2_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdma_spi2_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdma_spi2_rx.Init.Mode = DMA_NORMAL;
+	/* RX must win against TX, otherwise the RX FIFO overruns */
+	hdma_spi2_rx.Init.Priority = DMA_PRIORITY_HIGH;
+	HAL_DMA_Init(&hdma_spi2_rx);
+
+	__HAL_LINKDMA(&hspi, hdmarx, hdma_spi2_rx);
+
+	HAL_NVIC_SetPriority(SPI2_RX_DMA_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(SPI2_RX_DMA_IRQn);
+
+	/* WS2812b DMA runs at priority 0, the display can wait */
+	HAL_NVIC_SetPriority(SPI2_TX_DMA_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(SPI2_TX_DMA_IRQn);
+
+	/* SPI error interrupt, enabled by the HAL for DMA transfers */
+	HAL_NVIC_SetPriority(SPI2_IRQn, 1, 0);
+	HAL_NVIC_EnableIRQ(SPI2_IRQn);
+}
+
 /**
  * @fn SPI2_Init()
  * @brief Initialize SPI2.
@@ -41,14 +161,14 @@ void SPI2_Init() {
 	HAL_GPIO_Init(SPI2_CS_LCD_PORT, &GPIO_InitStructure);
 
 	/* Setup Chip Select (CS) for plug-wire */
-	//GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
-	//GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_HIGH;
-	//GPIO_InitStructure.Pin = SPI2_CS_PLUG_PIN;
-	//HAL_GPIO_Init(SPI2_CS_PLUG_PORT, &GPIO_InitStructure);
+	GPIO_InitStructure.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStructure.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStructure.Pin = SPI2_CS_PLUG_PIN;
+	HAL_GPIO_Init(SPI2_CS_PLUG_PORT, &GPIO_InitStructure);
 
 	/* Set Chip Select to negative LOW */
 	HAL_GPIO_WritePin(SPI2_CS_LCD_PORT, SPI2_CS_LCD_PIN, GPIO_PIN_SET);
-	//HAL_GPIO_WritePin(SPI2_CS_PLUG_PORT, SPI2_CS_PLUG_PIN, GPIO_PIN_SET);
+	HAL_GPIO_WritePin(SPI2_CS_PLUG_PORT, SPI2_CS_PLUG_PIN, GPIO_PIN_SET);
 
 
 	/* SPI2 MOSI MISO and CLK */
@@ -77,6 +197,7 @@ void SPI2_Init() {
 	hspi.Init.NSS = SPI_NSS_SOFT;
 	/* Specifies the Baud Rate prescaler value which will be used to configure the transmit and receive SCK clock */
 	hspi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8; // fPCLK / prescaler = 80MHz / 8 = 10MHz
+	/* Clock, mode and frame size are reprogrammed per device on selection, see SPI2_Devices */
 	/* Specifies whether data transfers start from MSB or LSB bit */
 	hspi.Init.FirstBit = SPI_FIRSTBIT_MSB;
 	/* Specifies if the TI mode is enabled or not.  */
@@ -89,8 +210,366 @@ void SPI2_Init() {
 	/* Initialize the SPI registers */
 	HAL_SPI_Init(&hspi);
 
-	/* Everything ready, we unlock the chip select */
-	SPI2_UnlockCS();
+	/* Setup DMA for buffer transmissions */
+	SPI2_DMA_Init();
+
+	/* Timestamps for the statistics */
+	DWT_CycleCounterInit();
+
+	/* Everything ready, the bus is free. Both chip selects are deasserted and
+	 * the state of the command/data wire is unknown, so that the next
+	 * selection applies chip select and profile again (e.g. on a second
+	 * LCD_Init). */
+	SPI2_Owner = SPI2_Device_None;
+	SPI2_ActiveDevice = SPI2_Device_None;
+	SPI2_CDCurrent = SPI2_CD_Keep;
+}
+
+/**
+ * @fn SPI2_ApplyProfile
+ * @brief Reprogram clock, mode and frame size of SPI2 if the profile differs
+ * from the current configuration. Must only be called while the bus is idle
+ * and no device is selected.
+ * @param config Device profile to apply.
+ */
+static void SPI2_ApplyProfile(const SPI2_DeviceConfig *config) {
+	if (hspi.Init.BaudRatePrescaler == config->BaudRatePrescaler &&
+			hspi.Init.CLKPolarity == config->CLKPolarity &&
+			hspi.Init.CLKPhase == config->CLKPhase &&
+			hspi.Init.DataSize == config->DataSize) {
+		return;
+	}
+
+	/* Clock and mode may only change while SPI2 is disabled. SPI2 is enabled
+	 * again by the next HAL or fast path transfer. */
+	__HAL_SPI_DISABLE(&hspi);
+	MODIFY_REG(SPI2->CR1, SPI_CR1_BR | SPI_CR1_CPOL | SPI_CR1_CPHA,
+			config->BaudRatePrescaler | config->CLKPolarity | config->CLKPhase);
+	/* RXNE threshold has to match the frame size */
+	MODIFY_REG(SPI2->CR2, SPI_CR2_DS | SPI_CR2_FRXTH,
+			config->DataSize | ((config->DataSize <= SPI_DATASIZE_8BIT) ? SPI_CR2_FRXTH : 0));
+
+	/* Keep the HAL view in sync */
+	hspi.Init.BaudRatePrescaler = config->BaudRatePrescaler;
+	hspi.Init.CLKPolarity = config->CLKPolarity;
+	hspi.Init.CLKPhase = config->CLKPhase;
+	hspi.Init.DataSize = config->DataSize;
+
+	SPI2_Statistics.Arbiter.ProfileChanges++;
+}
+
+/**
+ * @fn SPI2_ApplyChipSelect
+ * @brief Drive the chip select wires so that only one device is selected and
+ * apply the profile of the device.
+ * @param device Device to select.
+ */
+static void SPI2_ApplyChipSelect(SPI2_Device device) {
+	/* Disable all devices */
+	for (uint8_t i = 0; i < SPI2_Device_None; i++) {
+		HAL_GPIO_WritePin(SPI2_Devices[i].CSPort, SPI2_Devices[i].CSPin, GPIO_PIN_SET);
+	}
+
+	if (device < SPI2_Device_None) {
+		/* Clock polarity must settle before the device is selected */
+		SPI2_ApplyProfile(&SPI2_Devices[device]);
+		HAL_GPIO_WritePin(SPI2_Devices[device].CSPort, SPI2_Devices[device].CSPin, GPIO_PIN_RESET);
+	}
+
+	if (SPI2_ActiveDevice != SPI2_Device_None && device != SPI2_Device_None) {
+		SPI2_Statistics.Arbiter.DeviceSwitches++;
+	}
+	SPI2_ActiveDevice = device;
+}
+
+/**
+ * @fn SPI2_RecordCycles
+ * @brief Add a duration to a log2 histogram, see SPI2_HIST_BUCKETS.
+ * @param histogram Histogram to update.
+ * @param cycles Duration in DWT cycles.
+ */
+static void SPI2_RecordCycles(uint32_t *histogram, uint32_t cycles) {
+	int8_t bucket = (32 - __builtin_clz(cycles | 1)) - SPI2_HIST_MIN_SHIFT;
+	if (bucket < 0) bucket = 0;
+	if (bucket >= SPI2_HIST_BUCKETS) bucket = SPI2_HIST_BUCKETS - 1;
+	histogram[bucket]++;
+}
+
+/**
+ * @fn SPI2_SetCD
+ * @brief Drive the command/data wire. The wire is only written if the state
+ * changes, using a single BSRR write.
+ * @param cd Requested state, SPI2_CD_Keep leaves the wire untouched.
+ */
+void SPI2_SetCD(SPI2_CDState cd) {
+	if (cd == SPI2_CD_Keep || cd == SPI2_CDCurrent) {
+		return;
+	}
+	if (cd == SPI2_CD_Command) {
+		SPI2_CD_PORT->BSRR = (uint32_t)SPI2_CD_PIN << 16;
+	}
+	else {
+		SPI2_CD_PORT->BSRR = SPI2_CD_PIN;
+	}
+	SPI2_CDCurrent = cd;
+	SPI2_Statistics.CDToggles++;
+}
+
+/**
+ * @fn SPI2_Queue_StartNext
+ * @brief Start the DMA transfer of the oldest queued transaction.
+ * Must be called with interrupts disabled or from the SPI2 interrupt.
+ */
+static void SPI2_Queue_StartNext() {
+	while (SPI2_QueueCurrent < 0 && SPI2_QueueSuspended == 0 && SPI2_AcquirePending == 0 &&
+			SPI2_QueueDepth > 0) {
+		/* Oldest transaction per device. Within a device the order is never
+		 * changed, the LCD relies on command/data sequences. */
+		int8_t head[SPI2_Device_None];
+		for (uint8_t d = 0; d < SPI2_Device_None; d++) {
+			head[d] = -1;
+		}
+		for (int8_t i = 0; i < SPI2_QUEUE_SIZE; i++) {
+			if (!SPI2_Queue[i].Used) continue;
+			int8_t *h = &head[SPI2_Queue[i].Transaction.Device];
+			if (*h < 0 || (int32_t)(SPI2_Queue[i].Sequence - SPI2_Queue[*h].Sequence) < 0) {
+				*h = i;
+			}
+		}
+
+		/* Across devices: highest priority first. On equal priority group work
+		 * by device to save chip select toggles, but do not let one device
+		 * starve the others. Otherwise the oldest one wins. */
+		int8_t next = -1;
+		for (uint8_t d = 0; d < SPI2_Device_None; d++) {
+			int8_t h = head[d];
+			if (h < 0) continue;
+			if (next < 0) {
+				next = h;
+				continue;
+			}
+			SPI2_Transaction *a = &SPI2_Queue[h].Transaction;
+			SPI2_Transaction *b = &SPI2_Queue[next].Transaction;
+			if (a->Priority != b->Priority) {
+				if (a->Priority > b->Priority) next = h;
+			}
+			else if (SPI2_QueueBatch < SPI2_QUEUE_MAX_BATCH &&
+					(a->Device == SPI2_ActiveDevice || b->Device == SPI2_ActiveDevice)) {
+				if (a->Device == SPI2_ActiveDevice) next = h;
+			}
+			else if ((int32_t)(SPI2_Queue[h].Sequence - SPI2_Queue[next].Sequence) < 0) {
+				next = h;
+			}
+		}
+
+		SPI2_QueueSlot *slot = &SPI2_Queue[next];
+		SPI2_Transaction *t = &slot->Transaction;
+		if (t->Device == SPI2_ActiveDevice) {
+			SPI2_QueueBatch++;
+		}
+		else {
+			SPI2_QueueBatch = 0;
+		}
+
+		/* First chunk: bus grant latency of high priority requests */
+		if (slot->Offset == 0 && t->Priority == SPI2_Priority_High) {
+			uint32_t latency = DWT_GetCycles() - slot->EnqueueCycles;
+			if (latency > SPI2_Statistics.HighPriorityMaxLatency) {
+				SPI2_Statistics.HighPriorityMaxLatency = latency;
+			}
+		}
+		/* Another transaction got the bus at a chunk boundary */
+		if (SPI2_QueuePartial >= 0 && SPI2_QueuePartial != next) {
+			SPI2_Statistics.Preemptions++;
+		}
+
+		/* Everything below high priority is sent in chunks, so that high
+		 * priority requests get the bus at the next chunk boundary. A framed
+		 * transaction is a command for its device and must stay in one piece. */
+		slot->Chunk = t->Length - slot->Offset;
+		if (t->Priority < SPI2_Priority_High && !t->Framed && slot->Chunk > SPI2_QUEUE_CHUNK_SIZE) {
+			slot->Chunk = SPI2_QUEUE_CHUNK_SIZE;
+		}
+
+		/* A framed transaction starts with a fresh chip select edge, even if
+		 * the previous transaction was for the same device */
+		if (t->Device != SPI2_ActiveDevice || t->Framed) {
+			SPI2_ApplyChipSelect(t->Device);
+		}
+		SPI2_SetCD(t->CD);
+
+		/* Repeated byte: the channel is disabled between transfers, so the
+		 * memory increment can be changed here */
+		if (t->Repeat) {
+			CLEAR_BIT(hdma_spi2_tx.Instance->CCR, DMA_CCR_MINC);
+			hdma_spi2_tx.Init.MemInc = DMA_MINC_DISABLE;
+		}
+		else if (hdma_spi2_tx.Init.MemInc != DMA_MINC_ENABLE) {
+			SET_BIT(hdma_spi2_tx.Instance->CCR, DMA_CCR_MINC);
+			hdma_spi2_tx.Init.MemInc = DMA_MINC_ENABLE;
+		}
+
+		/* The HAL does not modify the buffer, it just lacks the const qualifier */
+		SPI2_QueueCurrent = next;
+		HAL_StatusTypeDef status;
+		if (t->RxData != NULL) {
+			status = HAL_SPI_TransmitReceive_DMA(&hspi, (uint8_t*)t->Data + slot->Offset,
+					t->RxData + slot->Offset, slot->Chunk);
+		}
+		else {
+			status = HAL_SPI_Transmit_DMA(&hspi, (uint8_t*)t->Data + (t->Repeat ? 0 : slot->Offset),
+					slot->Chunk);
+		}
+		if (status != HAL_OK) {
+			/* Drop transaction, the owner is told so it does not wait forever */
+			slot->Used = 0;
+			SPI2_QueueDepth--;
+			SPI2_QueueCurrent = -1;
+			SPI2_Statistics.Errors++;
+			if (t->Framed) {
+				SPI2_ApplyChipSelect(SPI2_Device_None);
+			}
+			if (SPI2_QueuePartial == next) {
+				SPI2_QueuePartial = -1;
+			}
+			if (t->Callback != NULL) {
+				t->Callback(SPI2_Error);
+			}
+		}
+	}
+}
+
+/**
+ * @fn SPI2_Enqueue
+ * @brief Append a transaction to the SPI2 queue. The transaction is
+ * transmitted using DMA in the background. Safe to call from thread and
+ * interrupt context. The data buffers must stay valid until the callback of
+ * the transaction has been called. If RxData is set, the transaction is full
+ * duplex and Length bytes are received into RxData. If Repeat is set, Data[0]
+ * is sent Length times.
+ * @param transaction Transaction to queue, the descriptor is copied.
+ * @return SPI2_OK on success, SPI2_Busy if the queue is full, SPI2_Invalid if
+ * the transaction is invalid.
+ */
+SPI2_Status SPI2_Enqueue(const SPI2_Transaction *transaction) {
+	if (transaction == NULL || transaction->Data == NULL || transaction->Length == 0 ||
+			transaction->Device >= SPI2_Device_None ||
+			(transaction->Repeat && transaction->RxData != NULL) ||
+			transaction->Priority < SPI2_Priority_Low || transaction->Priority > SPI2_Priority_High) {
+		return SPI2_Invalid;
+	}
+
+	SPI2_ENTER_CRITICAL();
+	for (uint8_t i = 0; i < SPI2_QUEUE_SIZE; i++) {
+		if (!SPI2_Queue[i].Used) {
+			SPI2_Queue[i].Transaction = *transaction;
+			SPI2_Queue[i].Sequence = SPI2_QueueSequence++;
+			SPI2_Queue[i].EnqueueCycles = DWT_GetCycles();
+			SPI2_Queue[i].Offset = 0;
+			SPI2_Queue[i].Used = 1;
+
+			SPI2_QueueDepth++;
+			if (SPI2_QueueDepth > SPI2_QueueHighWatermark) {
+				SPI2_QueueHighWatermark = SPI2_QueueDepth;
+			}
+
+			SPI2_Queue_StartNext();
+			SPI2_EXIT_CRITICAL();
+			return SPI2_OK;
+		}
+	}
+	SPI2_EXIT_CRITICAL();
+	return SPI2_Busy;
+}
+
+/**
+ * @fn SPI2_GetQueueDepth
+ * @brief Number of queued transactions, including the one on the bus.
+ * @return Queue depth.
+ */
+uint8_t SPI2_GetQueueDepth() {
+	return SPI2_QueueDepth;
+}
+
+/**
+ * @fn SPI2_GetQueueHighWatermark
+ * @brief Maximum queue depth since startup or the last reset.
+ * @return High watermark.
+ */
+uint8_t SPI2_GetQueueHighWatermark() {
+	return SPI2_QueueHighWatermark;
+}
+
+/**
+ * @fn SPI2_ResetQueueHighWatermark
+ * @brief Reset the high watermark to the current queue depth.
+ */
+void SPI2_ResetQueueHighWatermark() {
+	SPI2_QueueHighWatermark = SPI2_QueueDepth;
+}
+
+/**
+ * @fn SPI2_WaitQueueIdle
+ * @brief Block until all queued transactions have been transmitted.
+ * Returns at once while the queue is suspended, e.g. by the caller through
+ * SPI2_Acquire, the queue could not become idle. A stream that re-arms
+ * itself, see spi_plug.c, keeps the queue busy until it is stopped.
+ * Must not be called from interrupt context.
+ */
+void SPI2_WaitQueueIdle() {
+	uint32_t start = DWT_GetCycles();
+	if (SPI2_QueueDepth == 0) return;
+
+	while (SPI2_QueueDepth > 0 && SPI2_QueueSuspended == 0) {
+		// Do nothing....
+	}
+	SPI2_RecordCycles(SPI2_Statistics.WaitHistogram, DWT_GetCycles() - start);
+}
+
+/**
+ * @fn SPI2_SuspendQueue
+ * @brief Wait for the running transfer or chunk to finish and hold off queued
+ * transactions, so that the caller may use the bus directly. Transactions can
+ * still be queued while suspended. Calls can be nested.
+ * Must not be called from interrupt context.
+ */
+void SPI2_SuspendQueue() {
+	uint32_t start = DWT_GetCycles();
+	uint8_t waited = 0;
+
+	for (;;) {
+		SPI2_ENTER_CRITICAL();
+		if (SPI2_QueueCurrent < 0) {
+			SPI2_QueueSuspended++;
+			if (waited) {
+				SPI2_AcquirePending--;
+			}
+			SPI2_EXIT_CRITICAL();
+			if (waited) {
+				SPI2_RecordCycles(SPI2_Statistics.WaitHistogram, DWT_GetCycles() - start);
+			}
+			return;
+		}
+		/* Stop the queue at the next boundary */
+		if (!waited) {
+			SPI2_AcquirePending++;
+			waited = 1;
+		}
+		SPI2_EXIT_CRITICAL();
+	}
+}
+
+/**
+ * @fn SPI2_ResumeQueue
+ * @brief Counterpart of SPI2_SuspendQueue, restarts queue processing.
+ */
+void SPI2_ResumeQueue() {
+	SPI2_ENTER_CRITICAL();
+	if (SPI2_QueueSuspended > 0) {
+		SPI2_QueueSuspended--;
+	}
+	SPI2_Queue_StartNext();
+	SPI2_EXIT_CRITICAL();
 }
 
 /**
@@ -99,57 +578,434 @@ void SPI2_Init() {
  * @param data Data to send.
  */
 void SPI2_SendData(uint8_t data) {
-	/* Wait until SPI is ready */
-	while (HAL_SPI_GetState(&hspi) != HAL_SPI_STATE_READY) {
+	uint32_t start = DWT_GetCycles();
+
+	/* Keep the queue off the bus */
+	SPI2_SuspendQueue();
+
+	/* Send SPI data and wait until it has been clocked out */
+	SPI2_WriteByteFast(data);
+	SPI2_WaitIdleFast();
+
+	SPI2_Statistics.BytesSent++;
+	SPI2_Statistics.Transactions++;
+	SPI2_RecordCycles(SPI2_Statistics.LatencyHistogram, DWT_GetCycles() - start);
+
+	SPI2_ResumeQueue();
+}
+
+/**
+ * @fn SPI2_SendStream
+ * @brief Send a short buffer using SPI2 without DMA, e.g. a command sequence.
+ * The FIFO is kept full and the function waits only once at the end.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ */
+void SPI2_SendStream(const uint8_t *data, uint16_t length) {
+	uint32_t start = DWT_GetCycles();
+
+	SPI2_SuspendQueue();
+
+	SPI2_WriteStreamFast(data, length);
+	SPI2_WaitIdleFast();
+
+	SPI2_Statistics.BytesSent += length;
+	SPI2_Statistics.Transactions++;
+	SPI2_RecordCycles(SPI2_Statistics.LatencyHistogram, DWT_GetCycles() - start);
+
+	SPI2_ResumeQueue();
+}
+
+/**
+ * @fn SPI2_SendRepeated
+ * @brief Send the same byte several times using SPI2 without DMA, e.g. to
+ * fill display memory.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ */
+void SPI2_SendRepeated(uint8_t data, uint16_t length) {
+	uint32_t start = DWT_GetCycles();
+
+	SPI2_SuspendQueue();
+
+	SPI2_WriteRepeatFast(data, length);
+	SPI2_WaitIdleFast();
+
+	SPI2_Statistics.BytesSent += length;
+	SPI2_Statistics.Transactions++;
+	SPI2_RecordCycles(SPI2_Statistics.LatencyHistogram, DWT_GetCycles() - start);
+
+	SPI2_ResumeQueue();
+}
+
+/**
+ * @fn SPI2_SendBuffer_Complete
+ * @brief Transaction callback of SPI2_SendBuffer.
+ * @param status SPI2_OK or SPI2_Error, the buffer is released either way.
+ */
+static void SPI2_SendBuffer_Complete(SPI2_Status status) {
+	SPI2_SendBufferDone = 1;
+}
+
+/**
+ * @fn SPI2_SendBuffer
+ * @brief Send a buffer to the selected device using SPI2 and DMA. Blocks
+ * until the buffer and all transactions of the device queued before it have
+ * been sent. While the queue is suspended, e.g. because the caller owns the
+ * bus through SPI2_Acquire, the buffer is sent directly without DMA.
+ * Must not be called from interrupt context.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ */
+void SPI2_SendBuffer(const uint8_t *data, uint16_t length) {
+	uint32_t start = DWT_GetCycles();
+
+	if (length == 0) return;
+
+	/* The queue would not run before the caller resumes it */
+	if (SPI2_QueueSuspended > 0) {
+		SPI2_SendStream(data, length);
+		return;
+	}
+
+	/* Queue transfer, retry until a slot is free */
+	SPI2_SendBufferDone = 0;
+	SPI2_Status status;
+	while ((status = SPI2_SendBuffer_DMA(data, length, SPI2_SendBuffer_Complete)) == SPI2_Busy) {
+		// Do nothing....
+	}
+	if (status != SPI2_OK) return;
+
+	/* Wait for this transfer only, other devices may keep the queue busy */
+	while (!SPI2_SendBufferDone) {
 		// Do nothing....
 	}
-	/* Send SPI data */
-	 HAL_SPI_Transmit(&hspi, &data, 1, HAL_MAX_DELAY);
-	/* Wait for display */
-	for (int i = 0; i < 10; i ++);
+	SPI2_RecordCycles(SPI2_Statistics.WaitHistogram, DWT_GetCycles() - start);
+}
+
+/**
+ * @fn SPI2_SendBuffer_DMA
+ * @brief Queue a buffer for the selected device, it is transmitted using DMA.
+ * If no device is selected, the buffer is sent to the LCD.
+ * Returns immediately. The buffer must stay valid until the transfer is
+ * complete.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ * @param callback Called from interrupt context when the transfer is complete,
+ * may be NULL.
+ * @return SPI2_OK on success, SPI2_Busy if the queue is full, SPI2_Invalid if
+ * data is NULL.
+ */
+SPI2_Status SPI2_SendBuffer_DMA(const uint8_t *data, uint16_t length, SPI2_Callback callback) {
+	if (length == 0) {
+		if (callback != NULL) callback(SPI2_OK);
+		return SPI2_OK;
+	}
+
+	SPI2_Transaction transaction = {
+		.Device = (SPI2_ActiveDevice != SPI2_Device_None) ? SPI2_ActiveDevice : SPI2_Device_LCD,
+		.CD = SPI2_CD_Keep,
+		.Priority = SPI2_Priority_Normal,
+		.Data = data,
+		.Length = length,
+		.Callback = callback
+	};
+	return SPI2_Enqueue(&transaction);
+}
+
+/**
+ * @fn SPI2_IsBusy
+ * @brief Check if queued transactions are pending.
+ * @return 1 if SPI2 is busy, 0 otherwise.
+ */
+uint8_t SPI2_IsBusy() {
+	return SPI2_QueueDepth > 0;
+}
+
+/**
+ * @fn HAL_SPI_TxCpltCallback
+ * @brief Overwrite _weak HAL function. Called when a DMA transfer is complete.
+ * The HAL waits for the end of the transaction (BSY cleared) before calling,
+ * so the next transaction may change chip select and command/data wires.
+ * @param hspi_ref SPI handle.
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi_ref) {
+	if (hspi_ref->Instance == SPI2 && SPI2_QueueCurrent >= 0) {
+		SPI2_ENTER_CRITICAL();
+		SPI2_QueueSlot *slot = &SPI2_Queue[SPI2_QueueCurrent];
+		SPI2_Callback callback = NULL;
+
+		SPI2_Statistics.BytesSent += slot->Chunk;
+		slot->Offset += slot->Chunk;
+
+		if (slot->Offset < slot->Transaction.Length) {
+			/* More chunks to send, the scheduler may pick another device first */
+			SPI2_QueuePartial = SPI2_QueueCurrent;
+		}
+		else {
+			callback = slot->Transaction.Callback;
+			SPI2_Statistics.Transactions++;
+			/* End of the frame */
+			if (slot->Transaction.Framed) {
+				SPI2_ApplyChipSelect(SPI2_Device_None);
+			}
+			SPI2_RecordCycles(SPI2_Statistics.LatencyHistogram, DWT_GetCycles() - slot->EnqueueCycles);
+
+			slot->Used = 0;
+			SPI2_QueueDepth--;
+			SPI2_QueuePartial = -1;
+		}
+		SPI2_QueueCurrent = -1;
+
+		/* Keep the bus busy, then notify */
+		SPI2_Queue_StartNext();
+		SPI2_EXIT_CRITICAL();
+
+		if (callback != NULL) {
+			callback(SPI2_OK);
+		}
+	}
+}
+
+/**
+ * @fn HAL_SPI_TxRxCpltCallback
+ * @brief Overwrite _weak HAL function. Called when a full duplex DMA transfer
+ * is complete.
+ * @param hspi_ref SPI handle.
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi_ref) {
+	HAL_SPI_TxCpltCallback(hspi_ref);
+}
+
+/**
+ * @fn HAL_SPI_ErrorCallback
+ * @brief Overwrite _weak HAL function. Drop the failed transaction, report
+ * SPI2_Error to its callback and continue with the next one.
+ * @param hspi_ref SPI handle.
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi_ref) {
+	if (hspi_ref->Instance == SPI2 && SPI2_QueueCurrent >= 0) {
+		SPI2_ENTER_CRITICAL();
+		SPI2_Callback callback = SPI2_Queue[SPI2_QueueCurrent].Transaction.Callback;
+
+		if (SPI2_Queue[SPI2_QueueCurrent].Transaction.Framed) {
+			SPI2_ApplyChipSelect(SPI2_Device_None);
+		}
+		SPI2_Queue[SPI2_QueueCurrent].Used = 0;
+		SPI2_QueueDepth--;
+		SPI2_Statistics.Errors++;
+		if (SPI2_QueuePartial == SPI2_QueueCurrent) {
+			SPI2_QueuePartial = -1;
+		}
+		SPI2_QueueCurrent = -1;
+		SPI2_Queue_StartNext();
+		SPI2_EXIT_CRITICAL();
+
+		if (callback != NULL) {
+			callback(SPI2_Error);
+		}
+	}
+}
+
+/**
+ * @fn SPI2_Acquire
+ * @brief Take ownership of SPI2 for a device. Waits for the running queued
+ * transfer or chunk, then holds off the queue and selects the device. While
+ * waiting no further queued transaction is started. Queued
+ * transactions are kept and sent after SPI2_Release.
+ * From interrupt context only a timeout of 0 may be used.
+ * @param device Device that will use the bus.
+ * @param timeout Timeout in ms. 0 tries once, HAL_MAX_DELAY waits forever.
+ * @return SPI2_OK on success, SPI2_Busy if the bus is busy and timeout is 0,
+ * SPI2_Timeout on timeout, SPI2_Reentrant if the device already owns the bus,
+ * SPI2_Invalid for unknown devices.
+ */
+SPI2_Status SPI2_Acquire(SPI2_Device device, uint32_t timeout) {
+	uint32_t start = HAL_GetTick();
+	uint32_t start_cycles = DWT_GetCycles();
+	uint8_t contended = 0;
+	uint8_t pending = 0;
+
+	if (device >= SPI2_Device_None) return SPI2_Invalid;
+
+	for (;;) {
+		SPI2_ENTER_CRITICAL();
+		if (SPI2_Owner == device) {
+			/* Nested acquire, the caller would release the bus too early */
+			SPI2_Statistics.Arbiter.Reentrant++;
+			if (pending) {
+				SPI2_AcquirePending--;
+				SPI2_Queue_StartNext();
+			}
+			SPI2_EXIT_CRITICAL();
+			return SPI2_Reentrant;
+		}
+		if (SPI2_Owner == SPI2_Device_None && SPI2_QueueCurrent < 0) {
+			SPI2_Owner = device;
+			SPI2_QueueSuspended++;
+			if (pending) {
+				SPI2_AcquirePending--;
+			}
+			if (device != SPI2_ActiveDevice) {
+				SPI2_ApplyChipSelect(device);
+			}
+			SPI2_Statistics.Arbiter.Acquisitions++;
+			if (contended) {
+				SPI2_RecordCycles(SPI2_Statistics.WaitHistogram, DWT_GetCycles() - start_cycles);
+			}
+			SPI2_EXIT_CRITICAL();
+			return SPI2_OK;
+		}
+		if (!contended) {
+			contended = 1;
+			SPI2_Statistics.Arbiter.Contentions++;
+		}
+		if (timeout == 0) {
+			SPI2_EXIT_CRITICAL();
+			return SPI2_Busy;
+		}
+		if (timeout != HAL_MAX_DELAY && (HAL_GetTick() - start) >= timeout) {
+			SPI2_Statistics.Arbiter.Timeouts++;
+			/* Let the queue continue */
+			if (pending) {
+				SPI2_AcquirePending--;
+				SPI2_Queue_StartNext();
+			}
+			SPI2_EXIT_CRITICAL();
+			return SPI2_Timeout;
+		}
+		/* Stop the queue at the next boundary */
+		if (!pending) {
+			SPI2_AcquirePending++;
+			pending = 1;
+		}
+		SPI2_EXIT_CRITICAL();
+	}
+}
+
+/**
+ * @fn SPI2_Release
+ * @brief Give up ownership of SPI2 and restart queue processing. The chip
+ * select stays asserted until another device uses the bus.
+ * @param device Device that owns the bus.
+ * @return SPI2_OK on success, SPI2_Invalid if the device is not the owner.
+ */
+SPI2_Status SPI2_Release(SPI2_Device device) {
+	SPI2_ENTER_CRITICAL();
+	if (SPI2_Owner != device) {
+		SPI2_EXIT_CRITICAL();
+		return SPI2_Invalid;
+	}
+	SPI2_Owner = SPI2_Device_None;
+	SPI2_EXIT_CRITICAL();
+
+	SPI2_ResumeQueue();
+	return SPI2_OK;
+}
+
+/**
+ * @fn SPI2_GetOwner
+ * @brief Device owning SPI2.
+ * @return Owner, SPI2_Device_None if the bus is free.
+ */
+SPI2_Device SPI2_GetOwner() {
+	return SPI2_Owner;
 }
 
 /**
  * @fn SPI2_SelectDevice
  * @brief Select a SPI device using chip select wires.
+ * Does not take ownership, use SPI2_Acquire for that.
  * @param device Device to use.
- * @return 0 on success.
+ * @return SPI2_OK on success, SPI2_Busy if another device owns the bus or a
+ * queued transfer is running, SPI2_Invalid for unknown devices.
  */
-uint8_t SPI2_SelectDevice(SPI2_Device device) {
+SPI2_Status SPI2_SelectDevice(SPI2_Device device) {
+	if (device >= SPI2_Device_None) return SPI2_Invalid;
+
+	SPI2_ENTER_CRITICAL();
 	/* Abort if someone is already accessing the bus */
-	if (HAL_SPI_GetState(&hspi) != HAL_SPI_STATE_READY) return 0;
+	if ((SPI2_Owner != SPI2_Device_None && SPI2_Owner != device) || SPI2_QueueCurrent >= 0) {
+		SPI2_Statistics.Arbiter.Contentions++;
+		SPI2_EXIT_CRITICAL();
+		return SPI2_Busy;
+	}
+	if (device != SPI2_ActiveDevice) {
+		SPI2_ApplyChipSelect(device);
+	}
+	SPI2_EXIT_CRITICAL();
 
-	/* Disable all devices */
-	HAL_GPIO_WritePin(SPI2_CS_LCD_PORT, SPI2_CS_LCD_PIN, GPIO_PIN_SET);
-	HAL_GPIO_WritePin(SPI2_CS_PLUG_PORT, SPI2_CS_PLUG_PIN, GPIO_PIN_SET);
+	return SPI2_OK;
+}
 
-	switch (device) {
-		case SPI2_Device_LCD:
-			HAL_GPIO_WritePin(SPI2_CS_LCD_PORT, SPI2_CS_LCD_PIN, GPIO_PIN_RESET);
-			break;
-		case SPI2_Device_Plug:
-			HAL_GPIO_WritePin(SPI2_CS_PLUG_PORT, SPI2_CS_PLUG_PIN, GPIO_PIN_RESET);
-			break;
-		default:
-			return 1;
-		}
-  SPI2_LockCS();
+/**
+ * @fn SPI2_ConfigureDevice
+ * @brief Replace the profile (chip select, clock, mode, frame size) of a
+ * device. Takes effect the next time the device is selected. Only 8-bit
+ * frames are supported, the DMA channels, the queue and the fast path count
+ * bytes.
+ * @param device Device to configure.
+ * @param config New profile, copied.
+ * @return SPI2_OK on success, SPI2_Busy if the device is selected right now,
+ * SPI2_Invalid for unknown devices and frame sizes other than 8 bits.
+ */
+SPI2_Status SPI2_ConfigureDevice(SPI2_Device device, const SPI2_DeviceConfig *config) {
+	if (device >= SPI2_Device_None || config == NULL) return SPI2_Invalid;
+	if (config->DataSize != SPI_DATASIZE_8BIT) return SPI2_Invalid;
 
-  return 0;
+	SPI2_ENTER_CRITICAL();
+	if (SPI2_ActiveDevice == device && (SPI2_Owner != SPI2_Device_None || SPI2_QueueCurrent >= 0)) {
+		SPI2_EXIT_CRITICAL();
+		return SPI2_Busy;
+	}
+	/* Deselect, so that the next selection applies the new profile */
+	if (SPI2_ActiveDevice == device) {
+		SPI2_ApplyChipSelect(SPI2_Device_None);
+	}
+	SPI2_Devices[device] = *config;
+	SPI2_EXIT_CRITICAL();
+
+	return SPI2_OK;
+}
+
+/**
+ * @fn SPI2_GetArbiterStats
+ * @brief Copy the bus arbitration counters.
+ * @param stats Destination.
+ */
+void SPI2_GetArbiterStats(SPI2_ArbiterStats *stats) {
+	SPI2_ENTER_CRITICAL();
+	*stats = SPI2_Statistics.Arbiter;
+	SPI2_EXIT_CRITICAL();
+}
+
+/**
+ * @fn SPI2_ResetArbiterStats
+ * @brief Reset the bus arbitration counters.
+ */
+void SPI2_ResetArbiterStats() {
+	SPI2_ENTER_CRITICAL();
+	SPI2_Statistics.Arbiter = (SPI2_ArbiterStats){0};
+	SPI2_EXIT_CRITICAL();
 }
 
 /**
- * @fn SPI2_LockCS
- * @brief Lock SPI2 chip select / selected device.
+ * @fn SPI2_GetStats
+ * @brief Take a consistent snapshot of all SPI2 counters and histograms.
+ * @param stats Destination.
  */
-void SPI2_LockCS() {
-  SPI2_ChipSelectLocked = 1;
+void SPI2_GetStats(SPI2_Stats *stats) {
+	SPI2_ENTER_CRITICAL();
+	*stats = SPI2_Statistics;
+	SPI2_EXIT_CRITICAL();
 }
 
 /**
- * @fn SPI2_UnlockCS
- * @brief Unlock SPI2 chip select / selected device.
+ * @fn SPI2_ResetStats
+ * @brief Reset all SPI2 counters and histograms.
  */
-void SPI2_UnlockCS() {
-  SPI2_ChipSelectLocked = 0;
+void SPI2_ResetStats() {
+	SPI2_ENTER_CRITICAL();
+	SPI2_Statistics = (SPI2_Stats){0};
+	SPI2_EXIT_CRITICAL();
 }
@@ -16,9 +16,91 @@
 /* Public typedefs -----------------------------------------------------------*/
 typedef enum {
   SPI2_Device_LCD = 0,
-  SPI2_Device_Plug
+  SPI2_Device_Plug,
+  SPI2_Device_None		/* No device, bus is free */
 } SPI2_Device;
 
+typedef enum {
+  SPI2_OK = 0,
+  SPI2_Busy,
+  SPI2_Timeout,
+  SPI2_Reentrant,
+  SPI2_Invalid,
+  SPI2_Error		/* Transfer failed, passed to SPI2_Callback */
+} SPI2_Status;
+
+/* Bus arbitration counters */
+typedef struct {
+  uint32_t Acquisitions;	/* Successful SPI2_Acquire calls */
+  uint32_t Contentions;		/* Requests that found the bus busy */
+  uint32_t Timeouts;		/* SPI2_Acquire calls that timed out */
+  uint32_t Reentrant;		/* SPI2_Acquire calls by the current owner */
+  uint32_t DeviceSwitches;	/* Chip select changes between devices */
+  uint32_t ProfileChanges;	/* Clock/mode reconfigurations */
+} SPI2_ArbiterStats;
+
+/* Traffic counters and latency histograms. Histogram bucket 0 counts
+ * durations below 2^SPI2_HIST_MIN_SHIFT cycles, bucket n > 0 counts
+ * durations from 2^(n + SPI2_HIST_MIN_SHIFT - 1) cycles up to twice that.
+ * The last bucket also holds everything above. */
+#define SPI2_HIST_BUCKETS		16
+#define SPI2_HIST_MIN_SHIFT		6
+
+typedef struct {
+  uint32_t BytesSent;
+  uint32_t Transactions;	/* Queued transfers and blocking sends */
+  uint32_t CDToggles;		/* Changes of the command/data wire */
+  uint32_t Preemptions;		/* Chunked transfers interrupted by other devices */
+  uint32_t Errors;			/* Transactions dropped after SPI/DMA errors */
+  uint32_t HighPriorityMaxLatency;	/* Worst enqueue to bus grant, in cycles */
+  SPI2_ArbiterStats Arbiter;	/* Includes device switches */
+  uint32_t LatencyHistogram[SPI2_HIST_BUCKETS];	/* Enqueue/call until sent */
+  uint32_t WaitHistogram[SPI2_HIST_BUCKETS];	/* Busy waits for the bus */
+} SPI2_Stats;
+
+/* Per device bus profile */
+typedef struct {
+  GPIO_TypeDef *CSPort;
+  uint16_t CSPin;
+  uint32_t BaudRatePrescaler;	/* SPI_BAUDRATEPRESCALER_x */
+  uint32_t CLKPolarity;		/* SPI_POLARITY_x */
+  uint32_t CLKPhase;		/* SPI_PHASE_x */
+  uint32_t DataSize;		/* SPI_DATASIZE_8BIT, other sizes are rejected */
+} SPI2_DeviceConfig;
+
+typedef enum {
+  SPI2_CD_Keep = 0,
+  SPI2_CD_Command,
+  SPI2_CD_Data
+} SPI2_CDState;
+
+/* Queue priority. Only transactions of different devices overtake each other,
+ * per device the order of the queue is kept. */
+typedef enum {
+  SPI2_Priority_Low = -1,	/* Bulk transfers */
+  SPI2_Priority_Normal = 0,
+  SPI2_Priority_High = 1	/* Interactive updates, never split into chunks */
+} SPI2_Priority;
+
+/* Called from interrupt context when a DMA transfer has finished. status is
+ * SPI2_OK, or SPI2_Error if the transaction was dropped. On error the
+ * callback should not queue the transaction again, the error may persist. */
+typedef void (*SPI2_Callback)(SPI2_Status status);
+
+/* Queued SPI2 transfer */
+typedef struct {
+  SPI2_Device Device;		/* Chip select to assert */
+  SPI2_CDState CD;			/* State of the command/data wire */
+  const uint8_t *Data;		/* Must stay valid until the callback */
+  uint8_t *RxData;			/* Full duplex receive buffer or NULL */
+  uint16_t Length;
+  uint8_t Repeat;			/* Send Data[0] Length times, TX only */
+  uint8_t Framed;			/* Own chip select frame: asserted before, released
+							 * after the transaction, never split into chunks */
+  SPI2_Priority Priority;	/* 0 = SPI2_Priority_Normal */
+  SPI2_Callback Callback;	/* May be NULL */
+} SPI2_Transaction;
+
 /* Public defines ------------------------------------------------------------*/
 #define SPI2_CS_LCD_PIN   	GPIO_PIN_1
 #define SPI2_CS_LCD_PORT   	GPIOB
@@ -26,13 +108,139 @@ typedef enum {
 #define SPI2_CS_PLUG_PIN 	GPIO_PIN_10
 #define SPI2_CS_PLUG_PORT 	GPIOA
 
+/* Command/data wire of the LCD (LCD_CD_PIN), see SPI2_SetCD */
+#define SPI2_CD_PIN			GPIO_PIN_2
+#define SPI2_CD_PORT		GPIOB
+
+/* Maximum number of pending transactions */
+#define SPI2_QUEUE_SIZE		16
+/* Queued transactions of the active device that may overtake older
+ * transactions of other devices */
+#define SPI2_QUEUE_MAX_BATCH	8
+/* Transactions below SPI2_Priority_High are sent in chunks of this size. A
+ * high priority request waits for at most one chunk (51.2us at 10MHz), so
+ * does SPI2_Acquire. */
+#define SPI2_QUEUE_CHUNK_SIZE	64
+
+/* DMA1 channel 5, request 1 is hard-wired to SPI2_TX (RM0351 table 41).
+ * Channel 7 is used by TIM2 CH2 for the WS2812b leds. */
+#define SPI2_TX_DMA_CHANNEL	DMA1_Channel5
+#define SPI2_TX_DMA_REQUEST	DMA_REQUEST_1
+#define SPI2_TX_DMA_IRQn	DMA1_Channel5_IRQn
+/* DMA1 channel 4, request 1 is SPI2_RX */
+#define SPI2_RX_DMA_CHANNEL	DMA1_Channel4
+#define SPI2_RX_DMA_REQUEST	DMA_REQUEST_1
+#define SPI2_RX_DMA_IRQn	DMA1_Channel4_IRQn
+
 /* Public macros -------------------------------------------------------------*/
 /* Public variables ----------------------------------------------------------*/
 /* Public function prototypes ------------------------------------------------*/
 void SPI2_Init();
 void SPI2_SendData(uint8_t data);
-uint8_t SPI2_SelectDevice(SPI2_Device device);
-void SPI2_LockCS();
-void SPI2_UnlockCS();
+void SPI2_SendStream(const uint8_t *data, uint16_t length);
+void SPI2_SendRepeated(uint8_t data, uint16_t length);
+void SPI2_SendBuffer(const uint8_t *data, uint16_t length);
+SPI2_Status SPI2_SendBuffer_DMA(const uint8_t *data, uint16_t length, SPI2_Callback callback);
+uint8_t SPI2_IsBusy();
+SPI2_Status SPI2_Enqueue(const SPI2_Transaction *transaction);
+uint8_t SPI2_GetQueueDepth();
+uint8_t SPI2_GetQueueHighWatermark();
+void SPI2_ResetQueueHighWatermark();
+void SPI2_WaitQueueIdle();
+void SPI2_SuspendQueue();
+void SPI2_ResumeQueue();
+SPI2_Status SPI2_SelectDevice(SPI2_Device device);
+SPI2_Status SPI2_Acquire(SPI2_Device device, uint32_t timeout);
+SPI2_Status SPI2_Release(SPI2_Device device);
+SPI2_Device SPI2_GetOwner();
+SPI2_Status SPI2_ConfigureDevice(SPI2_Device device, const SPI2_DeviceConfig *config);
+void SPI2_GetArbiterStats(SPI2_ArbiterStats *stats);
+void SPI2_ResetArbiterStats();
+void SPI2_GetStats(SPI2_Stats *stats);
+void SPI2_ResetStats();
+void SPI2_SetCD(SPI2_CDState cd);
+
+/* Register level fast path --------------------------------------------------*/
+/* The functions below bypass the HAL state machine. The caller must own the
+ * bus (SPI2_Acquire) and SPI2 must be configured for 8-bit frames. */
+
+/**
+ * @fn SPI2_WriteByteFast
+ * @brief Put a single byte into the SPI2 TX FIFO. Returns as soon as the byte
+ * is queued in the FIFO, not when it has been sent.
+ * @param data Data to send.
+ */
+static inline void SPI2_WriteByteFast(uint8_t data) {
+	/* Enable SPI, the HAL only does this on its first transfer */
+	if (!(SPI2->CR1 & SPI_CR1_SPE)) SPI2->CR1 |= SPI_CR1_SPE;
+
+	/* TXE: TX FIFO is at most half full */
+	while (!(SPI2->SR & SPI_SR_TXE));
+	*(__IO uint8_t *)&SPI2->DR = data;
+}
+
+/**
+ * @fn SPI2_WriteStreamFast
+ * @brief Feed a buffer into the SPI2 TX FIFO. Two 8-bit frames are packed
+ * into every 16-bit write, the low byte is sent first. Returns as soon as
+ * the last byte is queued in the FIFO.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ */
+static inline void SPI2_WriteStreamFast(const uint8_t *data, uint16_t length) {
+	if (!(SPI2->CR1 & SPI_CR1_SPE)) SPI2->CR1 |= SPI_CR1_SPE;
+
+	/* Data packing: one 16-bit write whenever half of the FIFO is free */
+	while (length >= 2) {
+		while (!(SPI2->SR & SPI_SR_TXE));
+		*(__IO uint16_t *)&SPI2->DR = (uint16_t)(data[0] | (data[1] << 8));
+		data += 2;
+		length -= 2;
+	}
+	if (length) {
+		while (!(SPI2->SR & SPI_SR_TXE));
+		*(__IO uint8_t *)&SPI2->DR = *data;
+	}
+}
+
+/**
+ * @fn SPI2_WriteRepeatFast
+ * @brief Feed the same byte into the SPI2 TX FIFO several times, packed two
+ * frames per write. Returns as soon as the last byte is queued in the FIFO.
+ * @param data Data to send.
+ * @param length Number of bytes to send.
+ */
+static inline void SPI2_WriteRepeatFast(uint8_t data, uint16_t length) {
+	uint16_t packed = (uint16_t)(data | (data << 8));
+
+	if (!(SPI2->CR1 & SPI_CR1_SPE)) SPI2->CR1 |= SPI_CR1_SPE;
+
+	while (length >= 2) {
+		while (!(SPI2->SR & SPI_SR_TXE));
+		*(__IO uint16_t *)&SPI2->DR = packed;
+		length -= 2;
+	}
+	if (length) {
+		while (!(SPI2->SR & SPI_SR_TXE));
+		*(__IO uint8_t *)&SPI2->DR = data;
+	}
+}
+
+/**
+ * @fn SPI2_WaitIdleFast
+ * @brief Wait until the TX FIFO is empty and the last frame has left the
+ * shift register. Discards the bytes received meanwhile and clears the
+ * overrun flag, so that the HAL can continue afterwards.
+ */
+static inline void SPI2_WaitIdleFast() {
+	while (SPI2->SR & SPI_SR_FTLVL);
+	while (SPI2->SR & SPI_SR_BSY);
+
+	/* Full duplex: empty the RX FIFO, read DR then SR to clear OVR */
+	while (SPI2->SR & SPI_SR_FRLVL) {
+		(void)*(__IO uint8_t *)&SPI2->DR;
+	}
+	(void)SPI2->SR;
+}
 
 #endif /* _spi_h */
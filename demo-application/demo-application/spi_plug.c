@@ -0,0 +1,225 @@
+/********************************************************************************
+  * @file    	spi_plug.c
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Full duplex streaming for devices on the SPI2 plug connector.
+  *
+  * 			The plug device is sampled continuously in blocks of
+  * 			SPI2_PLUG_BLOCK_SIZE bytes. Every block is a full duplex DMA
+  * 			transaction on the SPI2 queue, re-armed from the completion
+  * 			interrupt. Between two blocks the queue may serve the LCD and
+  * 			SPI2_Acquire may take the bus, so both devices share the bus
+  * 			through chip select switching.
+  * 			Every block is framed by its own chip select assertion, see
+  * 			SPI2_Transaction.Framed. A circular DMA would hold the chip
+  * 			select forever.
+  * 			Completed blocks are kept in a ring together with a DWT
+  * 			timestamp and are fetched with SPI2_Plug_Read.
+********************************************************************************/
+
+/* Includes -------------------------------------------------------------------*/
+#include <string.h>
+#include "spi_plug.h"
+#include "dwt.h"
+
+/* External variables ---------------------------------------------------------*/
+/* Private typedefs -----------------------------------------------------------*/
+/* Private defines ------------------------------------------------------------*/
+/* Private macros -------------------------------------------------------------*/
+#define PLUG_ENTER_CRITICAL()	uint32_t primask = __get_PRIMASK(); __disable_irq()
+#define PLUG_EXIT_CRITICAL()	__set_PRIMASK(primask)
+
+/* Private variables ----------------------------------------------------------*/
+/* Receive ring */
+static uint8_t Plug_Ring[SPI2_PLUG_BLOCKS][SPI2_PLUG_BLOCK_SIZE];
+static uint32_t Plug_Timestamp[SPI2_PLUG_BLOCKS];
+/* Block filled by the DMA, oldest unread block, number of unread blocks */
+static volatile uint8_t Plug_Write = 0;
+static volatile uint8_t Plug_Read = 0;
+static volatile uint8_t Plug_Count = 0;
+
+/* Transmitted with every block, e.g. a read command followed by dummy bytes */
+static const uint8_t *Plug_TxBlock = NULL;
+static volatile uint8_t Plug_Running = 0;
+static volatile uint8_t Plug_Stalled = 0;
+/* A block is queued, its completion still writes the ring */
+static volatile uint8_t Plug_InFlight = 0;
+static SPI2_Plug_Stats Plug_Stats;
+
+/* Private function prototypes ------------------------------------------------*/
+static void Plug_Arm();
+static void Plug_BlockComplete(SPI2_Status status);
+
+/* Private functions ----------------------------------------------------------*/
+
+/**
+ * @fn Plug_Arm
+ * @brief Queue the transfer for the current write block.
+ * Called with interrupts disabled or from the SPI2 interrupt.
+ */
+static void Plug_Arm() {
+	SPI2_Transaction transaction = {
+		.Device = SPI2_Device_Plug,
+		.CD = SPI2_CD_Keep,
+		.Data = Plug_TxBlock,
+		.RxData = Plug_Ring[Plug_Write],
+		.Length = SPI2_PLUG_BLOCK_SIZE,
+		.Framed = 1,
+		.Priority = SPI2_Priority_Low,
+		.Callback = Plug_BlockComplete
+	};
+
+	/* Queue full: retry on the next SPI2_Plug_Read */
+	Plug_Stalled = (SPI2_Enqueue(&transaction) != SPI2_OK);
+	if (Plug_Stalled) {
+		Plug_Stats.Stalls++;
+	}
+	else {
+		Plug_InFlight = 1;
+	}
+}
+
+/**
+ * @fn Plug_BlockComplete
+ * @brief Transaction callback, publish the block and re-arm. A failed block
+ * is discarded, the stream restarts on the next SPI2_Plug_Read.
+ * @param status SPI2_OK or SPI2_Error.
+ */
+static void Plug_BlockComplete(SPI2_Status status) {
+	PLUG_ENTER_CRITICAL();
+	Plug_InFlight = 0;
+	if (status != SPI2_OK) {
+		Plug_Stats.Errors++;
+		Plug_Stalled = Plug_Running;
+		PLUG_EXIT_CRITICAL();
+		return;
+	}
+	Plug_Timestamp[Plug_Write] = DWT_GetCycles();
+	Plug_Stats.Blocks++;
+
+	Plug_Write = (Plug_Write + 1) % SPI2_PLUG_BLOCKS;
+	Plug_Count++;
+
+	/* Ring full, the next block would overwrite the oldest one: drop it */
+	if (Plug_Count == SPI2_PLUG_BLOCKS) {
+		Plug_Read = (Plug_Read + 1) % SPI2_PLUG_BLOCKS;
+		Plug_Count--;
+		Plug_Stats.Overruns++;
+	}
+
+	if (Plug_Running) {
+		Plug_Arm();
+	}
+	PLUG_EXIT_CRITICAL();
+}
+
+/* Public functions -----------------------------------------------------------*/
+
+/**
+ * @fn SPI2_Plug_StartStream
+ * @brief Start sampling the plug device. SPI2 must be initialized.
+ * @param tx_block SPI2_PLUG_BLOCK_SIZE bytes sent with every block. Must stay
+ * valid until the stream is stopped.
+ * @return 0 on success, 1 if the stream is running, the last block of a
+ * stopped stream is still queued or tx_block is NULL.
+ */
+uint8_t SPI2_Plug_StartStream(const uint8_t *tx_block) {
+	if (tx_block == NULL) {
+		return 1;
+	}
+
+	PLUG_ENTER_CRITICAL();
+	/* Resetting the ring under a queued block would let its completion
+	 * write a stale slot and start a second chain of blocks */
+	if (Plug_Running || Plug_InFlight) {
+		PLUG_EXIT_CRITICAL();
+		return 1;
+	}
+	Plug_TxBlock = tx_block;
+	Plug_Write = 0;
+	Plug_Read = 0;
+	Plug_Count = 0;
+	Plug_Stats = (SPI2_Plug_Stats){0};
+	Plug_Running = 1;
+	Plug_Arm();
+	PLUG_EXIT_CRITICAL();
+
+	return 0;
+}
+
+/**
+ * @fn SPI2_Plug_StopStream
+ * @brief Stop sampling. A queued block is completed and not re-armed, unread
+ * blocks can still be read. The stream can be restarted once
+ * SPI2_Plug_IsBusy returns 0.
+ */
+void SPI2_Plug_StopStream() {
+	PLUG_ENTER_CRITICAL();
+	Plug_Running = 0;
+	Plug_Stalled = 0;
+	PLUG_EXIT_CRITICAL();
+}
+
+/**
+ * @fn SPI2_Plug_IsBusy
+ * @brief Check if the stream runs or a block of a stopped stream is queued.
+ * @return 1 if busy, 0 otherwise.
+ */
+uint8_t SPI2_Plug_IsBusy() {
+	return Plug_Running || Plug_InFlight;
+}
+
+/**
+ * @fn SPI2_Plug_Read
+ * @brief Fetch the oldest completed block. Does not block.
+ * @param data Destination.
+ * @param size Size of destination, at most SPI2_PLUG_BLOCK_SIZE bytes are
+ * copied.
+ * @param timestamp DWT cycle count at completion of the block, may be NULL.
+ * @return Number of bytes copied, 0 if no block is available.
+ */
+uint16_t SPI2_Plug_Read(uint8_t *data, uint16_t size, uint32_t *timestamp) {
+	uint16_t length = 0;
+
+	PLUG_ENTER_CRITICAL();
+	if (Plug_Count > 0) {
+		length = (size < SPI2_PLUG_BLOCK_SIZE) ? size : SPI2_PLUG_BLOCK_SIZE;
+		/* Copy with interrupts disabled, the ISR may drop this block */
+		memcpy(data, Plug_Ring[Plug_Read], length);
+		if (timestamp != NULL) {
+			*timestamp = Plug_Timestamp[Plug_Read];
+		}
+		Plug_Read = (Plug_Read + 1) % SPI2_PLUG_BLOCKS;
+		Plug_Count--;
+	}
+
+	/* Restart a stream that could not be queued */
+	if (Plug_Running && Plug_Stalled) {
+		Plug_Arm();
+	}
+	PLUG_EXIT_CRITICAL();
+
+	return length;
+}
+
+/**
+ * @fn SPI2_Plug_Available
+ * @brief Number of completed blocks that have not been read.
+ * @return Number of blocks.
+ */
+uint8_t SPI2_Plug_Available() {
+	return Plug_Count;
+}
+
+/**
+ * @fn SPI2_Plug_GetStats
+ * @brief Copy the stream counters.
+ * @param stats Destination.
+ */
+void SPI2_Plug_GetStats(SPI2_Plug_Stats *stats) {
+	PLUG_ENTER_CRITICAL();
+	*stats = Plug_Stats;
+	PLUG_EXIT_CRITICAL();
+}
@@ -0,0 +1,41 @@
+/********************************************************************************
+  * @file    	spi_plug.h
+  * @author  	paspf
+  * @version 	V1.0
+  * @date    	2022-03-22
+  * @copyright	paspf, GNU Public License 3
+  * @brief   	Full duplex streaming for devices on the SPI2 plug connector.
+********************************************************************************/
+
+#ifndef _spi_plug_h
+#define _spi_plug_h
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32l4xx.h"
+#include "spi.h"
+
+/* Public typedefs -----------------------------------------------------------*/
+typedef struct {
+  uint32_t Blocks;			/* Completed blocks */
+  uint32_t Overruns;		/* Blocks dropped because the reader was too slow */
+  uint32_t Stalls;			/* Restarts after the SPI2 queue was full */
+  uint32_t Errors;			/* Blocks lost to SPI/DMA errors */
+} SPI2_Plug_Stats;
+
+/* Public defines ------------------------------------------------------------*/
+/* Receive ring: number of blocks and bytes per block. 2 blocks give a
+ * classic double buffer, one block is filled while the other one is read. */
+#define SPI2_PLUG_BLOCKS		4
+#define SPI2_PLUG_BLOCK_SIZE	64
+
+/* Public macros -------------------------------------------------------------*/
+/* Public variables ----------------------------------------------------------*/
+/* Public function prototypes ------------------------------------------------*/
+uint8_t SPI2_Plug_StartStream(const uint8_t *tx_block);
+void SPI2_Plug_StopStream();
+uint8_t SPI2_Plug_IsBusy();
+uint16_t SPI2_Plug_Read(uint8_t *data, uint16_t size, uint32_t *timestamp);
+uint8_t SPI2_Plug_Available();
+void SPI2_Plug_GetStats(SPI2_Plug_Stats *stats);
+
+#endif /* _spi_plug_h */
@@ -7,13 +7,20 @@
   * @brief   	Runs all tests for L476RG ES-EP v1.0
 ********************************************************************************/
 
+#include <stdio.h>
+#include <inttypes.h>
 #include "tests.h"
 #include "leds.h"
 #include "lcd_drawing.h"
+#include "lcd_console.h"
 #include "pushbutton.h"
 #include "ws2812b.h"
+#include "spi.h"
+#include "dwt.h"
 #include "stm32l4xx.h"
 
+extern SPI_HandleTypeDef hspi;
+
 /**
  * @fn test_buttons
  * @brief Test all three buttons. On button press 'ok'
@@ -197,3 +204,180 @@ uint8_t test_ws2812() {
 	uint8_t pressed = wait_for_user_input();
 	return determine_test_result(pressed, 5);
 }
+
+/**
+ * @fn benchmark_spi2_fastpath
+ * @brief Measure the cycles needed to send the page/column command triple
+ * emitted by LCD_SetPageData. The HAL path sends byte by byte like the former
+ * SPI2_SendData, the fast path streams the triple through the TX FIFO.
+ * The LCD must be initialized, only address commands are sent.
+ * @param hal_cycles Average cycles per triple using HAL_SPI_Transmit.
+ * @param fast_cycles Average cycles per triple using the fast path.
+ */
+void benchmark_spi2_fastpath(uint32_t *hal_cycles, uint32_t *fast_cycles) {
+	const uint8_t cmd[3] = {0xB0, 0x10, 0x00};
+	uint32_t start;
+
+	DWT_CycleCounterInit();
+	SPI2_Acquire(SPI2_Device_LCD, HAL_MAX_DELAY);
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
+
+	// HAL path.
+	start = DWT_GetCycles();
+	for (int round = 0; round < TST_BENCH_ROUNDS; round++) {
+		for (int i = 0; i < 3; i++) {
+			while (HAL_SPI_GetState(&hspi) != HAL_SPI_STATE_READY);
+			HAL_SPI_Transmit(&hspi, (uint8_t*)&cmd[i], 1, HAL_MAX_DELAY);
+			for (volatile int j = 0; j < 10; j++);
+		}
+	}
+	*hal_cycles = (DWT_GetCycles() - start) / TST_BENCH_ROUNDS;
+
+	// Register level fast path.
+	start = DWT_GetCycles();
+	for (int round = 0; round < TST_BENCH_ROUNDS; round++) {
+		SPI2_WriteStreamFast(cmd, 3);
+		SPI2_WaitIdleFast();
+	}
+	*fast_cycles = (DWT_GetCycles() - start) / TST_BENCH_ROUNDS;
+
+	// The triples moved the controller cursor behind the LCD driver's back.
+	LCD_InvalidateCursor();
+
+	SPI2_Release(SPI2_Device_LCD);
+}
+
+/**
+ * @fn benchmark_lcd_init
+ * @brief Measure the cycles from LCD_Init() to the first visible pixel and
+ * the panel configuration alone. The configuration is timed twice: byte by
+ * byte like the former LCD_ConfigDisplay, which set C/D and called
+ * HAL_SPI_Transmit for every command, and as the single burst sent by
+ * LCD_ConfigDisplay now. The init time includes SPI2_Init and the GPIO setup.
+ * @param init_cycles Cycles from LCD_Init() to the first pixel.
+ * @param hal_config_cycles Cycles of the configuration sent byte by byte.
+ * @param burst_config_cycles Cycles of the configuration sent as burst.
+ */
+void benchmark_lcd_init(uint32_t *init_cycles, uint32_t *hal_config_cycles, uint32_t *burst_config_cycles) {
+	uint32_t start;
+
+	DWT_CycleCounterInit();
+
+	// Init to first pixel.
+	start = DWT_GetCycles();
+	LCD_Init();
+	LCD_SetPageData(0, 0, 0x01);
+	*init_cycles = DWT_GetCycles() - start;
+
+	// Configuration, burst.
+	start = DWT_GetCycles();
+	LCD_ConfigDisplay();
+	*burst_config_cycles = DWT_GetCycles() - start;
+
+	// Configuration, byte by byte through the HAL like the former driver.
+	SPI2_Acquire(SPI2_Device_LCD, HAL_MAX_DELAY);
+	start = DWT_GetCycles();
+	for (int i = 0; i < LCD_PanelInit.Length; i++) {
+		HAL_GPIO_WritePin(LCD_CD_PORT, LCD_CD_PIN, GPIO_PIN_RESET);
+		while (HAL_SPI_GetState(&hspi) != HAL_SPI_STATE_READY);
+		HAL_SPI_Transmit(&hspi, (uint8_t*)&LCD_PanelInit.Commands[i], 1, HAL_MAX_DELAY);
+		for (volatile int j = 0; j < 10; j++);
+	}
+	*hal_config_cycles = DWT_GetCycles() - start;
+
+	// C/D was written behind the SPI driver's back, bring its state in line.
+	LCD_SetLCDMode(LCD_COMMAND_MODE);
+	SPI2_Release(SPI2_Device_LCD);
+}
+
+/**
+ * @fn benchmark_font_codec
+ * @brief Compare LCD_Font_21x28 with its run length encoded version
+ * LCD_CFont_21x28. Reports the flash footprint of both and how fast every
+ * page of every glyph is turned into page row data: gathered from the
+ * column interleaved raw font like LCD_Print, or decoded like LCD_PrintC.
+ * No SPI transfers are involved.
+ * @param raw_size Bytes of the uncompressed font.
+ * @param rle_size Bytes of the compressed font including its index.
+ * @param raw_rate Bytes per second produced from the raw font.
+ * @param rle_rate Bytes per second produced by the decoder.
+ */
+void benchmark_font_codec(uint32_t *raw_size, uint32_t *rle_size, uint32_t *raw_rate, uint32_t *rle_rate) {
+	const LCD_CFont *font = &LCD_CFont_21x28;
+	uint8_t row[LCD_Width];
+	uint32_t glyph_size = font->Width * font->PagesPerChar;
+	uint32_t bytes = TST_BENCH_ROUNDS * font->Count * glyph_size;
+	uint32_t start, cycles;
+	LCD_RLE_Decoder decoder;
+	volatile uint8_t sink;
+
+	*raw_size = 4 + font->Count * glyph_size;
+	*rle_size = font->Offsets[font->Count] + (font->Count + 1) * sizeof(uint16_t);
+
+	DWT_CycleCounterInit();
+
+	// Raw font, column interleaved.
+	start = DWT_GetCycles();
+	for (int round = 0; round < TST_BENCH_ROUNDS; round++) {
+		for (int c = 0; c < font->Count; c++) {
+			for (int page = 0; page < font->PagesPerChar; page++) {
+				const uint8_t *v = &LCD_Font_Data(LCD_Font_21x28, c * glyph_size + page);
+				for (int x = 0; x < font->Width; x++, v += font->PagesPerChar) {
+					row[x] = *v;
+				}
+			}
+		}
+	}
+	cycles = DWT_GetCycles() - start;
+	sink = row[0];
+	*raw_rate = (uint64_t)bytes * SystemCoreClock / cycles;
+
+	// Run length encoded, page by page.
+	start = DWT_GetCycles();
+	for (int round = 0; round < TST_BENCH_ROUNDS; round++) {
+		for (int c = 0; c < font->Count; c++) {
+			LCD_RLE_Init(&decoder, &font->Data[font->Offsets[c]]);
+			for (int page = 0; page < font->PagesPerChar; page++) {
+				LCD_RLE_Read(&decoder, row, font->Width);
+			}
+		}
+	}
+	cycles = DWT_GetCycles() - start;
+	sink = row[0];
+	(void)sink;
+	*rle_rate = (uint64_t)bytes * SystemCoreClock / cycles;
+}
+
+#if TST_RUN_BENCHMARKS
+/**
+ * @fn run_benchmarks
+ * @brief Run all benchmarks and print the results on the display using the
+ * LCD console. The console is stopped afterwards. Re-initializes the LCD, the
+ * caller has to redraw afterwards.
+ * Cycles are DWT cycles at SystemCoreClock.
+ */
+void run_benchmarks() {
+	uint32_t hal_cycles, fast_cycles, init_cycles, hal_config_cycles, burst_config_cycles;
+	uint32_t raw_size, rle_size, raw_rate, rle_rate;
+
+	// LCD_Init first, it resets the display.
+	benchmark_lcd_init(&init_cycles, &hal_config_cycles, &burst_config_cycles);
+	benchmark_spi2_fastpath(&hal_cycles, &fast_cycles);
+	benchmark_font_codec(&raw_size, &rle_size, &raw_rate, &rle_rate);
+
+	LCD_Console_Init(LCD_Font_6x7int);
+	LCD_Console_ShowCursor(0);
+	printf("cmd HAL   %8" PRIu32 "\n", hal_cycles);
+	printf("cmd fast  %8" PRIu32 "\n", fast_cycles);
+	printf("cfg HAL   %8" PRIu32 "\n", hal_config_cycles);
+	printf("cfg burst %8" PRIu32 "\n", burst_config_cycles);
+	printf("init      %8" PRIu32 "\n", init_cycles);
+	printf("21x28 B %5" PRIu32 "/%5" PRIu32 "\n", raw_size, rle_size);
+	printf("raw  %7" PRIu32 " kB/s\n", raw_rate / 1000);
+	printf("RLE  %7" PRIu32 " kB/s", rle_rate / 1000);
+	fflush(stdout);
+
+	HAL_Delay(TST_BENCH_SHOW_MS);
+	LCD_Console_Stop();
+}
+#endif /* TST_RUN_BENCHMARKS */
@@ -16,11 +16,22 @@
 
 /* Exported macros -----------------------------------------------------------*/
 #define TST_OK_POS_0 20
+#define TST_BENCH_ROUNDS 64
+/* Set to 1 to run the benchmarks before the component tests */
+#ifndef TST_RUN_BENCHMARKS
+#define TST_RUN_BENCHMARKS 0
+#endif
+/* Time the benchmark results stay on the display */
+#define TST_BENCH_SHOW_MS 5000
 
 /* Exported functions ------------------------------------------------------- */
 uint8_t test_buttons();
 uint8_t test_leds();
 uint8_t test_board_led();
 uint8_t test_ws2812();
+void benchmark_spi2_fastpath(uint32_t *hal_cycles, uint32_t *fast_cycles);
+void benchmark_lcd_init(uint32_t *init_cycles, uint32_t *hal_config_cycles, uint32_t *burst_config_cycles);
+void benchmark_font_codec(uint32_t *raw_size, uint32_t *rle_size, uint32_t *raw_rate, uint32_t *rle_rate);
+void run_benchmarks();
 
 #endif /* _TEST_H */
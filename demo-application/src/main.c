@@ -64,11 +64,17 @@ int main(void) {
 	// Initialize periphery leds.
 	leds_periphery_board_init();
 
+#if TST_RUN_BENCHMARKS
+	// Opt-in: measure display and SPI paths, results are shown for a few seconds.
+	run_benchmarks();
+#endif
+
 	// Initialize display.
 	LCD_Init();
 	LCD_ClearFast();
 
-	// Plot demo text to display.
+	// Plot demo text to display. Draw into RAM, then send it at once.
+	LCD_SetDrawMode(LCD_DRAW_BUFFERED);
 	LCD_Print(52, 1, "demo", LCD_Font_6x7lcd);
 	LCD_DrawLine(0, 18, 127, 18);
 	LCD_Print(0, 3, "B1:", LCD_Font_6x7lcd);
@@ -77,6 +83,8 @@ int main(void) {
 	LCD_Print(50, 3, "D1-8:", LCD_Font_6x7lcd);
 	LCD_Print(50, 4, "BRD:", LCD_Font_6x7lcd);
 	LCD_Print(50, 5, "WSx:", LCD_Font_6x7lcd);
+	LCD_Flush();
+	LCD_SetDrawMode(LCD_DRAW_DIRECT);
 
 	// Initialize WS2812b leds.
 	TIM2_Init();
@@ -59,6 +59,7 @@
 extern int errno;
 extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
+extern int LCD_Console_Write(char *ptr, int len) __attribute__((weak));
 
 register char * stack_ptr asm("sp");
 
@@ -104,6 +105,12 @@ int _write(int file, char *ptr, int len)
 {
 	int DataIdx;
 
+	/* stdout and stderr go to the LCD console once it is started */
+	if ((file == 1 || file == 2) && LCD_Console_Write && LCD_Console_Write(ptr, len) >= 0)
+	{
+		return len;
+	}
+
 	for (DataIdx = 0; DataIdx < len; DataIdx++)
 	{
 		__io_putchar(*ptr++);
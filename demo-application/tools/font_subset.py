@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+"""Generate subset fonts containing only the glyphs the firmware prints.
+
+The sources are scanned for LCD_Print calls with a string literal and a
+font constant, e.g. LCD_Print(0, 3, "B1:", LCD_Font_6x7lcd). For every font
+used only this way a subset is emitted as proportional font (LCD_PFont)
+holding the used glyphs at their full cell width, so the layout does not
+change. The range table of LCD_PFont remaps the code points to the glyphs.
+
+Fonts referenced in any other way, e.g. with a string only known at
+runtime, passed to the console or read by the profiler overlay, are kept
+in full and their LCD_Print calls are not redirected.
+
+Build the firmware with LCD_FONT_SUBSET defined and lcd_fonts_subset.c
+added to use the subsets. With --gc-sections unreferenced full fonts are
+not linked.
+
+Usage, run from demo-application/ before building:
+    python3 tools/font_subset.py demo-application/lcd_fonts.c \\
+        src/*.c demo-application/*.c
+"""
+
+import argparse
+import os
+import re
+import sys
+
+FONT_DEF = re.compile(r"const\s+uint8_t\s+(LCD_Font_\w+)\s*\[\s*\]\s*=\s*\{([^}]*)\}", re.S)
+FONT_REF = re.compile(r"\bLCD_Font_\w+\b")
+PRINT_CALL = re.compile(
+    r"\bLCD_Print\s*\(\s*[^,()]+,\s*[^,()]+,\s*\"((?:[^\"\\]|\\.)*)\"\s*,\s*(LCD_Font_\w+)\s*\)")
+COMMENT = re.compile(r"//[^\n]*|/\*.*?\*/", re.S)
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "\\": "\\", "\"": "\"", "'": "'", "0": "\0"}
+
+
+def strip_comments(text):
+    return COMMENT.sub(" ", text)
+
+
+def unescape(literal):
+    out = []
+    i = 0
+    while i < len(literal):
+        c = literal[i]
+        if c == "\\" and i + 1 < len(literal):
+            n = literal[i + 1]
+            if n == "x":
+                m = re.match(r"[0-9A-Fa-f]+", literal[i + 2:])
+                out.append(chr(int(m.group(0), 16) & 0xFF))
+                i += 2 + len(m.group(0))
+                continue
+            out.append(ESCAPES.get(n, n))
+            i += 2
+            continue
+        out.append(c)
+        i += 1
+    return "".join(out)
+
+
+def parse_fonts(path):
+    with open(path, encoding="latin-1") as f:
+        text = strip_comments(f.read())
+    fonts = {}
+    for name, body in FONT_DEF.findall(text):
+        values = [int(v, 0) for v in re.findall(r"0x[0-9A-Fa-f]+|\d+", body)]
+        fonts[name] = values
+    return fonts
+
+
+def scan(paths, fonts):
+    used = {name: set() for name in fonts}
+    runtime = set()
+    for path in paths:
+        with open(path, encoding="latin-1") as f:
+            text = strip_comments(f.read())
+        literal_refs = {}
+        for literal, font in PRINT_CALL.findall(text):
+            if font in used:
+                used[font].update(unescape(literal))
+                literal_refs[font] = literal_refs.get(font, 0) + 1
+        for font in set(FONT_REF.findall(text)):
+            if font not in used:
+                continue
+            # Every other reference means the font is needed in full
+            if len(re.findall(r"\b%s\b" % font, text)) > literal_refs.get(font, 0):
+                runtime.add(font)
+    return used, runtime
+
+
+def ranges(codes):
+    out = []
+    for c in codes:
+        if out and out[-1][1] == c - 1:
+            out[-1][1] = c
+        else:
+            out.append([c, c])
+    return out
+
+
+def emit(fonts, used, runtime, out_dir):
+    subsets = [f for f in sorted(fonts) if used[f] and f not in runtime]
+    header = [
+        "/* Generated by tools/font_subset.py, do not edit. */",
+        "/* LCD_Print_<font> is selected by LCD_Print in lcd_drawing.h. */",
+        "",
+        "#ifndef _lcd_fonts_subset_h",
+        "#define _lcd_fonts_subset_h",
+        "",
+    ]
+    source = [
+        "/* Generated by tools/font_subset.py, do not edit. */",
+        "",
+        "#include \"lcd_drawing.h\"",
+        "",
+        "#ifdef LCD_FONT_SUBSET",
+        "",
+    ]
+    full_bytes = subset_bytes = 0
+
+    for name in sorted(fonts):
+        short = name[len("LCD_Font_"):]
+        if name not in subsets:
+            reason = "used at runtime" if name in runtime else "not printed"
+            header.append("/* %s: full font, %s */" % (name, reason))
+            header.append("#define LCD_Print_%s(X, P, S)\t(LCD_Print)(X, P, S, %s)" % (name, name))
+            header.append("")
+            continue
+
+        data = fonts[name]
+        width, height, pages, offset = data[:4]
+        cell = width * pages
+        codes = sorted(ord(c) for c in used[name] if c != " " and ord(c) >= offset)
+        columns = []
+        for c in codes:
+            start = 4 + (c - offset) * cell
+            glyph = data[start:start + cell]
+            if len(glyph) != cell:
+                sys.exit("%s has no glyph for %r" % (name, chr(c)))
+            columns.append((c, glyph))
+        table = ranges(codes)
+
+        source.append("/* %s subset: %s */" % (name, "".join(chr(c) for c in codes)))
+        source.append("static const uint8_t LCD_SFont_%s_Columns[] =\n{" % short)
+        for c, glyph in columns:
+            source.append("  %s, /* %s */" % (", ".join("0x%02X" % b for b in glyph),
+                                              "0x%02X" % c if chr(c) in "*/\\" else chr(c)))
+        source.append("};\n")
+        source.append("static const uint16_t LCD_SFont_%s_Offsets[] =\n{\n  %s\n};\n" % (
+            short, ", ".join(str(i * width) for i in range(len(codes) + 1))))
+        source.append("static const LCD_PFontRange LCD_SFont_%s_Ranges[] =\n{" % short)
+        glyph = 0
+        for first, last in table:
+            source.append("  {0x%02X, 0x%02X, %d}," % (first, last, glyph))
+            glyph += last - first + 1
+        source.append("};\n")
+        source.append("""const LCD_PFont LCD_SFont_%s =
+{
+  .Height = %d,
+  .PagesPerChar = %d,
+  .Spacing = 0,
+  .SpaceWidth = %d,
+  .RangeCount = %d,
+  .KerningCount = 0,
+  .Ranges = LCD_SFont_%s_Ranges,
+  .Offsets = LCD_SFont_%s_Offsets,
+  .Columns = LCD_SFont_%s_Columns,
+  .Kerning = 0
+};
+""" % (short, height, pages, width, len(table), short, short, short))
+
+        size = len(codes) * cell + 2 * (len(codes) + 1) + 4 * len(table) + 20
+        full_bytes += len(data)
+        subset_bytes += size
+        header.append("/* %s: %d of %d glyphs, about %d instead of %d bytes */" % (
+            name, len(codes), (len(data) - 4) // cell, size, len(data)))
+        header.append("extern const LCD_PFont LCD_SFont_%s;" % short)
+        header.append("#define LCD_Print_%s(X, P, S)\tLCD_PrintP(X, P, S, &LCD_SFont_%s)" % (name, short))
+        header.append("")
+
+    header.append("#endif")
+    source.append("#endif")
+
+    with open(os.path.join(out_dir, "lcd_fonts_subset.h"), "w") as f:
+        f.write("\n".join(header) + "\n")
+    with open(os.path.join(out_dir, "lcd_fonts_subset.c"), "w") as f:
+        f.write("\n".join(source) + "\n")
+    return subsets, full_bytes, subset_bytes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("fonts", help="lcd_fonts.c holding the full fonts")
+    parser.add_argument("sources", nargs="+", help="sources to scan for LCD_Print calls")
+    parser.add_argument("--out-dir", help="output directory, default: directory of the fonts")
+    args = parser.parse_args()
+
+    fonts = parse_fonts(args.fonts)
+    sources = [s for s in args.sources
+               if not os.path.basename(s).startswith("lcd_fonts")]
+    used, runtime = scan(sources, fonts)
+    out_dir = args.out_dir or os.path.dirname(args.fonts)
+    subsets, full_bytes, subset_bytes = emit(fonts, used, runtime, out_dir)
+
+    for name in sorted(fonts):
+        state = "subset" if name in subsets else ("full" if name in runtime else "unused")
+        print("%-16s %s" % (name, state))
+    if subsets:
+        print("subsets: %d bytes instead of %d" % (subset_bytes, full_bytes))
+
+
+if __name__ == "__main__":
+    main()